@@ -0,0 +1,84 @@
+/**
+ * The MIT License
+ *
+ * Copyright 2022 Krishna sssky307@163.com
+ *
+ * For the full copyright and license information, please view the LICENSE
+ * file that was distributed with this source code.
+ */
+
+#pragma once
+
+#include "SyntaxTree.h"
+
+#include <chrono>
+#include <random>
+#include <vector>
+
+//
+// The helpers shared by the benchmarks.
+//
+
+//
+// The best wall time of runs calls of func, in seconds.
+//
+template <typename Func>
+double seconds(Func func, int runs = 1)
+{
+    double best = 1e30;
+    for (int i = 0; i < runs; ++i)
+    {
+        auto t0 = std::chrono::steady_clock::now();
+        func();
+        auto t1 = std::chrono::steady_clock::now();
+        auto t = std::chrono::duration<double>(t1 - t0).count();
+        if (t < best) best = t;
+    }
+    return best;
+}
+
+//
+// A random tree of nodeCount nodes, built in preorder. A node is appended
+// to the open path, which is closed one level at a time with odds of 1 in
+// popOdds and never deeper than maxDepth. label() gives each node label.
+//
+template <typename Label>
+cst::Node *makeTree(cst::SyntaxTree &tree, std::size_t nodeCount, std::size_t maxDepth, 
+                    unsigned popOdds, std::mt19937 &rng, Label label)
+{
+    auto root = tree.newNode(label());
+    std::vector<cst::Node *> path{root};
+    for (std::size_t i = 1; i < nodeCount; ++i)
+    {
+        while (path.size() > 1 && (path.size() > maxDepth || rng() % popOdds == 0))
+        {
+            path.pop_back();
+        }
+        auto node = tree.newNode(label());
+        path.back()->append(node);
+        if (rng() % 3 == 0)
+        {
+            path.push_back(node);
+        }
+    }
+    return root;
+}
+
+//
+// A random phrase with short labels, built in preorder.
+//
+inline void addPhrase(cst::SyntaxTree &tree, cst::Node *parent, std::mt19937 &random, int depth)
+{
+    static const char *labels[] = {"S", "NP", "VP", "PP", "D", "N", "V", "the", "word", "runs"};
+    auto node = tree.newNode(labels[random() % 10]);
+    parent->append(node);
+    if (depth <= 0)
+    {
+        return;
+    }
+    auto children = 1 + random() % 3;
+    for (std::size_t i = 0; i < children; ++i)
+    {
+        addPhrase(tree, node, random, depth - 1 - static_cast<int>(random() % 2));
+    }
+}
@@ -0,0 +1,113 @@
+/**
+ * The MIT License
+ *
+ * Copyright 2022 Krishna sssky307@163.com
+ *
+ * For the full copyright and license information, please view the LICENSE
+ * file that was distributed with this source code.
+ */
+
+#include "Lexer.h"
+
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <string>
+
+using namespace cst;
+
+using Level = CharScanner::Level;
+
+//
+// Generate a label-heavy tree, about size bytes.
+//
+std::string makeTree(std::size_t size, std::size_t minLabel, std::size_t maxLabel)
+{
+    std::mt19937 rng(7);
+    std::string s;
+    s.reserve(size + 1024);
+    std::size_t depth = 0;
+    s += "[ROOT";
+    ++depth;
+    while (s.size() < size)
+    {
+        auto r = rng() % 10;
+        if ((r < 3 && depth < 12) || depth == 1)
+        {
+            s += "\n" + std::string(depth * 4, ' ') + "[";
+            ++depth;
+        }
+        else if (r < 6 && depth > 1)
+        {
+            s += "]";
+            --depth;
+            continue;
+        }
+        else
+        {
+            s += " ";
+        }
+        auto len = minLabel + rng() % (maxLabel - minLabel + 1);
+        for (std::size_t i = 0; i < len; ++i)
+        {
+            s += static_cast<char>('a' + rng() % 26);
+        }
+    }
+    while (depth-- > 0)
+    {
+        s += "]";
+    }
+    return s;
+}
+
+double run(const std::string &text, Level level, std::size_t &tokens)
+{
+    double best = 0.0;
+    for (int i = 0; i < 5; ++i)
+    {
+        auto t0 = std::chrono::steady_clock::now();
+        Lexer lexer((const uint8_t *)text.data(), text.size(), level);
+        tokens = 0;
+        while (static_cast<int>(lexer.getNextTokenType()) > 0)
+        {
+            ++tokens;
+        }
+        auto t1 = std::chrono::steady_clock::now();
+        auto gbps = text.size() / std::chrono::duration<double>(t1 - t0).count() / 1e9;
+        if (gbps > best) best = gbps;
+    }
+    return best;
+}
+
+int main()
+{
+    struct Case
+    {
+        const char *name;
+        std::size_t minLabel;
+        std::size_t maxLabel;
+    } cases[] = {
+        {"short labels (2~6)", 2, 6},
+        {"word labels (4~12)", 4, 12},
+        {"long labels (16~64)", 16, 64},
+    };
+
+    for (auto &c : cases)
+    {
+        auto text = makeTree(64 << 20, c.minLabel, c.maxLabel);
+        std::cout << "==" << c.name << ", " << (text.size() >> 20) << " MB\n";
+        for (auto level : {Level::Scalar, Level::SSE2, Level::AVX2})
+        {
+            if (static_cast<int>(level) > static_cast<int>(CharScanner::bestLevel()))
+                continue;
+
+            std::size_t tokens = 0;
+            auto gbps = run(text, level, tokens);
+            std::cout << "  " << CharScanner::levelName(level)
+                      << "\t" << gbps << " GB/s"
+                      << "\t" << tokens << " tokens\n";
+        }
+    }
+
+    return 0;
+}
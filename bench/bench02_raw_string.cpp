@@ -0,0 +1,96 @@
+/**
+ * The MIT License
+ *
+ * Copyright 2022 Krishna sssky307@163.com
+ *
+ * For the full copyright and license information, please view the LICENSE
+ * file that was distributed with this source code.
+ */
+
+#include "Lexer.h"
+#include "BenchUtil.h"
+
+#include <cstring>
+#include <iostream>
+#include <string>
+
+using namespace cst;
+
+//
+// R"<delim>( [<piece>]... )<delim>"
+//
+std::string makeRawString(std::size_t bodySize, const std::string &delim, const std::string &piece)
+{
+    std::string s = "R\"" + delim + "(";
+    while (s.size() < bodySize)
+    {
+        s += piece;
+    }
+    s += ")" + delim + "\"";
+    return s;
+}
+
+//
+// Reference: restart at every ')' and compare the whole terminator.
+//
+std::size_t restartMatcher(const std::string &s, const std::string &delim)
+{
+    std::string terminator = ")" + delim + "\"";
+    auto p = s.data() + 2 + delim.size() + 1;
+    auto end = s.data() + s.size();
+    while ((p = (const char *)std::memchr(p, ')', end - p)) != nullptr)
+    {
+        if (static_cast<std::size_t>(end - p) >= terminator.size()
+            && std::memcmp(p, terminator.data(), terminator.size()) == 0)
+        {
+            return p - s.data();
+        }
+        ++p;
+    }
+    return 0;
+}
+
+int main()
+{
+    //
+    // [partial]: delimiter [aa...ab], every ')' in the body starts a partial
+    //            match which fails at the last delimiter char.
+    // [dense]  : delimiter [))...)b], the body is all ')', every byte starts
+    //            a partial match, a restarting matcher is O(n * delimiter).
+    //
+    for (auto family : {"partial", "dense"})
+    {
+        bool dense = std::string(family) == "dense";
+        for (std::size_t delimSize : {1, 16, 256, 4096})
+        {
+            std::string delim(delimSize - 1, dense ? ')' : 'a');
+            delim += 'b';
+            std::string piece = dense ? std::string(64, ')') : ")" + delim.substr(0, delim.size() - 1);
+            std::cout << "==" << family << ", delimiter length " << delimSize << "\n";
+            for (std::size_t mb : {1, 4, 16})
+            {
+                if (dense && delimSize * mb > 4096)
+                    continue; // The restarting matcher takes too long.
+
+                auto text = makeRawString(mb << 20, delim, piece);
+                std::size_t tokenSize = 0;
+                auto lexerTime = seconds([&]()
+                {
+                    Lexer lexer((const uint8_t *)text.data(), text.size());
+                    lexer.getNextTokenType();
+                    tokenSize = lexer.getCurrentToken().size();
+                }, 3);
+                std::size_t found = 0;
+                auto restartTime = seconds([&]() { found = restartMatcher(text, delim); }, 3);
+
+                std::cout << "  " << mb << " MB"
+                          << "\tkmp " << text.size() / lexerTime / 1e6 << " MB/s"
+                          << "\trestart " << text.size() / restartTime / 1e6 << " MB/s"
+                          << ((tokenSize + 2 + delim.size() * 2 + 2 + 1 == text.size() && found) ? "" : "\tMISMATCH")
+                          << "\n";
+            }
+        }
+    }
+
+    return 0;
+}
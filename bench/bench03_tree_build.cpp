@@ -0,0 +1,103 @@
+/**
+ * The MIT License
+ *
+ * Copyright 2022 Krishna sssky307@163.com
+ *
+ * For the full copyright and license information, please view the LICENSE
+ * file that was distributed with this source code.
+ */
+
+#include "Parser.h"
+#include "SyntaxTree.h"
+#include "BenchUtil.h"
+
+#include <iostream>
+#include <random>
+#include <string>
+
+using namespace cst;
+
+//
+// A random tree with about nodeCount nodes and short labels.
+//
+std::string makeTree(std::size_t nodeCount)
+{
+    std::mt19937 rng(7);
+    std::string s = "[root";
+    std::size_t depth = 1;
+    for (std::size_t i = 1; i < nodeCount; ++i)
+    {
+        auto r = rng() % 8;
+        if (r < 2 && depth < 24)
+        {
+            s += " [n" + std::to_string(i);
+            ++depth;
+        }
+        else if (r < 4 && depth > 1)
+        {
+            s += "] leaf";
+            --depth;
+        }
+        else
+        {
+            s += " w" + std::to_string(i % 1000);
+        }
+    }
+    s += std::string(depth, ']');
+    return s;
+}
+
+//
+// The same tree with every node on the heap.
+//
+Node *copyToHeap(const Node *t)
+{
+    auto root = new Node(t->label());
+    std::vector<std::pair<const Node *, Node *>> stack{{t, root}};
+    while (!stack.empty())
+    {
+        auto from = stack.back().first;
+        auto to = stack.back().second;
+        stack.pop_back();
+        for (auto child : from->childArray())
+        {
+            auto node = new Node(child->label());
+            to->append(node);
+            stack.emplace_back(child, node);
+        }
+    }
+    return root;
+}
+
+int main()
+{
+    for (std::size_t n : {100000, 1000000, 4000000})
+    {
+        auto text = makeTree(n);
+
+        SyntaxTreePtr tree;
+        auto parseTime = seconds([&]() { tree = Parser::buildSyntaxTree(text); });
+        if (!tree)
+        {
+            std::cout << "parse failed\n";
+            return 1;
+        }
+        auto blocks = tree->arena().blockCount();
+        auto mb = tree->arena().capacity() / 1e6;
+
+        Node *heapRoot = nullptr;
+        auto heapBuildTime = seconds([&]() { heapRoot = copyToHeap(tree->getRoot()); });
+
+        auto arenaFreeTime = seconds([&]() { tree.reset(); });
+        auto heapFreeTime = seconds([&]() { SyntaxTree::freeTree(heapRoot); });
+
+        std::cout << "==" << n << " nodes\n"
+                  << "  parse (arena)   " << parseTime * 1e3 << " ms, "
+                  << blocks << " blocks, " << mb << " MB\n"
+                  << "  build (heap)    " << heapBuildTime * 1e3 << " ms\n"
+                  << "  free  (arena)   " << arenaFreeTime * 1e3 << " ms\n"
+                  << "  free  (heap)    " << heapFreeTime * 1e3 << " ms\n";
+    }
+
+    return 0;
+}
@@ -0,0 +1,310 @@
+/**
+ * The MIT License
+ *
+ * Copyright 2022 Krishna sssky307@163.com
+ *
+ * For the full copyright and license information, please view the LICENSE
+ * file that was distributed with this source code.
+ */
+
+#include "Layouter.h"
+#include "FlatTree.h"
+#include "SyntaxTree.h"
+#include "BenchUtil.h"
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+using namespace cst;
+
+//
+// Count last level cache misses of this thread, if the kernel allows it.
+//
+class CacheMisses
+{
+public:
+    CacheMisses()
+    {
+#ifdef __linux__
+        perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.size = sizeof(attr);
+        attr.config = PERF_COUNT_HW_CACHE_MISSES;
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        fd_ = static_cast<int>(syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0));
+#endif
+    }
+    ~CacheMisses()
+    {
+#ifdef __linux__
+        if (fd_ >= 0) close(fd_);
+#endif
+    }
+    bool good() const { return fd_ >= 0; }
+    void start()
+    {
+#ifdef __linux__
+        if (fd_ < 0) return;
+        ioctl(fd_, PERF_EVENT_IOC_RESET, 0);
+        ioctl(fd_, PERF_EVENT_IOC_ENABLE, 0);
+#endif
+    }
+    long long stop()
+    {
+        long long count = -1;
+#ifdef __linux__
+        if (fd_ < 0) return count;
+        ioctl(fd_, PERF_EVENT_IOC_DISABLE, 0);
+        if (read(fd_, &count, sizeof(count)) != sizeof(count)) count = -1;
+#endif
+        return count;
+    }
+
+private:
+    int fd_ = -1;
+};
+
+//
+// Reference: a pointer linked node which holds its own layout fields, as
+// Node did before Layouter moved to FlatTree. It keeps a label, a textbox
+// and a child vector, so it is about as large as a syntax tree node.
+//
+struct FatNode
+{
+    FatNode *parent = nullptr;
+    std::vector<FatNode *> children;
+    std::string label;
+    TextBox textBox;
+    FatNode *ancestor = this;
+    FatNode *thread = nullptr;
+    double prelim = {};
+    double mod = {};
+    double x = {};
+    double y = {};
+    double shift = {};
+    double change = {};
+
+    bool isLeaf() const { return children.empty(); }
+};
+
+//
+// Copy a syntax tree into fat nodes, each one a separate heap object.
+//
+FatNode *makeFatTree(Node *t, std::vector<std::unique_ptr<FatNode>> &storage, 
+                     std::unordered_map<const Node *, FatNode *> &fatOf)
+{
+    storage.emplace_back(new FatNode);
+    auto v = storage.back().get();
+    v->label.assign(t->label().data(), t->label().size());
+    v->textBox = t->textBox();
+    fatOf[t] = v;
+    for (auto child : t->childArray())
+    {
+        auto w = makeFatTree(child, storage, fatOf);
+        w->parent = v;
+        v->children.push_back(w);
+    }
+    return v;
+}
+
+//
+// Reference: the BJL walks on node pointers.
+//
+class NodeLayouter
+{
+public:
+    explicit NodeLayouter(double hSep, double vSep) : hSep_(hSep), vSep_(vSep) {}
+
+    void layout(FatNode *t)
+    {
+        FirstWalk(t, nullptr);
+        SecondWalk(t, -t->prelim, 0);
+    }
+
+private:
+    double hSep_;
+    double vSep_;
+
+    void FirstWalk(FatNode *v, FatNode *leftSibling)
+    {
+        if (!v->isLeaf())
+        {
+            auto dac = v->children.front();
+            FatNode *left = nullptr;
+            for (auto child : v->children)
+            {
+                FirstWalk(child, left);
+                dac = Apportion(child, left, dac);
+                left = child;
+            }
+            ExecuteShifts(v);
+            auto midpoint = (v->children.front()->prelim + v->children.back()->prelim) * 0.5;
+            if (leftSibling)
+            {
+                v->prelim = leftSibling->prelim + hSep_;
+                v->mod = v->prelim - midpoint;
+            }
+            else
+            {
+                v->prelim = midpoint;
+            }
+        }
+        else if (leftSibling)
+        {
+            v->prelim = leftSibling->prelim + hSep_;
+        }
+    }
+
+    void SecondWalk(FatNode *v, double m, std::size_t level)
+    {
+        v->x = v->prelim + m;
+        v->y = level * vSep_;
+        for (auto child : v->children)
+        {
+            SecondWalk(child, m + v->mod, level + 1);
+        }
+    }
+
+    FatNode *Apportion(FatNode *v, FatNode *leftSibling, FatNode *dac)
+    {
+        if (leftSibling)
+        {
+            auto RL = v, RR = v, LR = leftSibling, LL = v->parent->children.front();
+            auto LLMod = LL->mod, LRMod = LR->mod, RLMod = RL->mod, RRMod = RR->mod;
+            while (NextRight(LR) && NextLeft(RL))
+            {
+                LL = NextLeft(LL);
+                LR = NextRight(LR);
+                RL = NextLeft(RL);
+                RR = NextRight(RR);
+                RR->ancestor = v;
+                auto shift = (LR->prelim + LRMod) - (RL->prelim + RLMod) + hSep_;
+                if (shift > 0.0f)
+                {
+                    MoveSubTree(LR->ancestor->parent == v->parent ? LR->ancestor : dac, v, shift);
+                    RLMod += shift;
+                    RRMod += shift;
+                }
+                LLMod += LL->mod;
+                LRMod += LR->mod;
+                RLMod += RL->mod;
+                RRMod += RR->mod;
+            }
+            if (NextRight(LR) && !NextRight(RR))
+            {
+                RR->thread = NextRight(LR);
+                RR->mod = RR->mod + LRMod - RRMod;
+            }
+            if (NextLeft(RL) && !NextLeft(LL))
+            {
+                LL->thread = NextLeft(RL);
+                LL->mod = LL->mod + RLMod - LLMod;
+                dac = v;
+            }
+        }
+        return dac;
+    }
+
+    FatNode *NextLeft(FatNode *v) { return v->isLeaf() ? v->thread : v->children.front(); }
+    FatNode *NextRight(FatNode *v) { return v->isLeaf() ? v->thread : v->children.back(); }
+
+    void MoveSubTree(FatNode *w0, FatNode *w1, double shift)
+    {
+        auto &siblings = w0->parent->children;
+        auto left = std::find(siblings.begin(), siblings.end(), w0);
+        auto right = std::find(left, siblings.end(), w1);
+        auto subtrees = right - left;
+        w1->change -= shift / subtrees;
+        w1->shift += shift;
+        w0->change += shift / subtrees;
+        w1->prelim += shift;
+        w1->mod += shift;
+    }
+
+    void ExecuteShifts(FatNode *v)
+    {
+        double shift = {}, change = {};
+        auto &children = v->children;
+        for (auto it = children.rbegin(); it != children.rend(); ++it)
+        {
+            (*it)->prelim += shift;
+            (*it)->mod += shift;
+            change += (*it)->change;
+            shift += (*it)->shift + change;
+        }
+    }
+};
+
+int main()
+{
+    const double hSep = option::NodeSep::defHSep;
+    const double vSep = option::NodeSep::defVSep;
+    CacheMisses misses;
+
+    for (std::size_t n : {100000, 1000000})
+    {
+        SyntaxTree tree;
+        std::mt19937 rng(11);
+        tree.setRoot(makeTree(tree, n, 32, 4, rng, []() { return "n"; }));
+
+        std::vector<std::unique_ptr<FatNode>> storage;
+        std::unordered_map<const Node *, FatNode *> fatOf;
+        auto fatRoot = makeFatTree(tree.getRoot(), storage, fatOf);
+
+        NodeLayouter nodeLayouter(hSep, vSep);
+        misses.start();
+        auto nodeTime = seconds([&]() { nodeLayouter.layout(fatRoot); });
+        auto nodeMisses = misses.stop();
+
+        FlatTree flat;
+        auto flattenTime = seconds([&]() { flat.assign(tree.getRoot()); });
+
+        Layouter layouter;
+        TreeSize treeSize;
+        misses.start();
+        auto flatTime = seconds([&]() { layouter.layout(flat, treeSize); });
+        auto flatMisses = misses.stop();
+
+        std::size_t mismatch = 0;
+        for (std::size_t i = 0; i < flat.size(); ++i)
+        {
+            auto v = fatOf[flat.node[i]];
+            if (flat.x[i] != v->x || flat.y[i] != v->y)
+            {
+                ++mismatch;
+            }
+        }
+
+        auto missStr = [&](long long count)
+        {
+            return misses.good() ? std::to_string(count) : std::string("n/a");
+        };
+        std::cout << "==" << n << " nodes\n"
+                  << "  node walk   " << nodeTime * 1e3 << " ms, cache misses " << missStr(nodeMisses) << "\n"
+                  << "  flat walk   " << flatTime * 1e3 << " ms, cache misses " << missStr(flatMisses) << "\n"
+                  << "  flatten     " << flattenTime * 1e3 << " ms\n"
+                  << "  mismatch    " << mismatch << "\n";
+        if (mismatch)
+        {
+            return 1;
+        }
+    }
+
+    return 0;
+}
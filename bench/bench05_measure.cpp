@@ -0,0 +1,113 @@
+/**
+ * The MIT License
+ *
+ * Copyright 2022 Krishna sssky307@163.com
+ *
+ * For the full copyright and license information, please view the LICENSE
+ * file that was distributed with this source code.
+ */
+
+#include "Layouter.h"
+#include "FlatTree.h"
+#include "SyntaxTree.h"
+#include "TextBoxCache.h"
+#include "GlyphMetrics.h"
+#include "ThreadPool.h"
+#include "BenchUtil.h"
+
+#include <algorithm>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace cst;
+
+//
+// Usage: bench05_measure [max jobs], the default is the hardware thread count.
+//
+int main(int argc, char *argv[])
+{
+    const std::size_t n = 1000000;
+    RenderOptions options;
+    SyntaxTree tree;
+
+    // Treebank-like labels: most are a few dozen tags, the rest are words
+    // from a large vocabulary.
+    static const char *tags[] = {"S", "NP", "VP", "PP", "DT", "NN", "NNS", "VBZ", "VBD", "IN",
+                                 "JJ", "RB", "CC", "PRP", "SBAR", "ADJP", "ADVP", "WHNP", "TO", "MD"};
+    std::mt19937 rng(5);
+    tree.setRoot(makeTree(tree, n, 32, 4, rng, [&]()
+    {
+        // One word in eight is not ascii, it goes through the locked glyph shards.
+        auto word = (rng() % 8 == 0 ? "w\xC3\xB6rd" : "word") + std::to_string(rng() % 200000);
+        return rng() % 3 == 0 ? word : std::string(tags[rng() % 20]);
+    }));
+    FlatTree flat(tree.getRoot());
+
+    std::size_t maxJobs = (std::max)(1u, std::thread::hardware_concurrency());
+    if (argc > 1)
+    {
+        maxJobs = (std::max)(std::size_t(1), static_cast<std::size_t>(std::stoul(argv[1])));
+    }
+
+    // 1, 2, 4, ... and maxJobs itself.
+    std::vector<std::size_t> jobList;
+    for (std::size_t jobs = 1; jobs < maxJobs; jobs *= 2)
+    {
+        jobList.push_back(jobs);
+    }
+    jobList.push_back(maxJobs);
+
+    std::vector<std::string> labels;
+    for (auto v : flat.node)
+    {
+        labels.emplace_back(v->label().c_str());
+    }
+
+    // The glyph metrics column measures every label with one shared
+    // GlyphMetrics and no textbox cache, it scales unless the metrics
+    // serialize the threads.
+    std::cout << "==" << n << " nodes, measure pass\n"
+              << "  jobs   cairo cold   glyph cold   warm cache   glyph metrics\n";
+    for (auto jobs : jobList)
+    {
+        ThreadPool pool(jobs);
+
+        // Cold: every run starts with an empty textbox cache and new metrics.
+        Layouter cairoLayouter(options, std::make_shared<TextBoxCache>());
+        cairoLayouter.setThreadPool(&pool);
+        auto cairoTime = seconds([&]() { cairoLayouter.measure(flat); });
+
+        auto cache = std::make_shared<TextBoxCache>();
+        Layouter glyphLayouter(options, cache, std::make_shared<GlyphMetrics>(options));
+        glyphLayouter.setThreadPool(&pool);
+        auto glyphTime = seconds([&]() { glyphLayouter.measure(flat); });
+
+        // Warm: the same cache again, every label is a hit.
+        auto hits = cache->hits();
+        auto warmTime = seconds([&]() { glyphLayouter.measure(flat); });
+        auto warmHitRate = static_cast<double>(cache->hits() - hits) / flat.size();
+
+        const std::size_t chunkSize = 4096;
+        auto metrics = std::make_shared<GlyphMetrics>(options);
+        auto metricsTime = seconds([&]() {
+            pool.parallelFor((labels.size() + chunkSize - 1) / chunkSize, [&](std::size_t index, std::size_t) {
+                auto end = (std::min)((index + 1) * chunkSize, labels.size());
+                for (auto i = index * chunkSize; i < end; ++i)
+                {
+                    metrics->getTextBox(labels[i]);
+                }
+            });
+        });
+
+        std::cout << "  " << jobs << "\t " 
+                  << cairoTime * 1e3 << " ms\t" 
+                  << glyphTime * 1e3 << " ms\t" 
+                  << warmTime * 1e3 << " ms (hit rate " << warmHitRate << ")\t"
+                  << metricsTime * 1e3 << " ms\n";
+    }
+
+    return 0;
+}
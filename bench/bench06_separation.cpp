@@ -0,0 +1,107 @@
+/**
+ * The MIT License
+ *
+ * Copyright 2022 Krishna sssky307@163.com
+ *
+ * For the full copyright and license information, please view the LICENSE
+ * file that was distributed with this source code.
+ */
+
+#include "Layouter.h"
+#include "Renderer.h"
+#include "Boxy.h"
+#include "SyntaxTree.h"
+#include "BenchUtil.h"
+
+#include <algorithm>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace cst;
+
+struct Result
+{
+    double area = {};
+    double renderTime = {};
+    bool drawn = false;
+
+    std::string str() const
+    {
+        auto time = drawn ? std::to_string(renderTime * 1e3) + " ms" : std::string("too large");
+        return std::to_string(static_cast<long long>(area)) + ", " + time;
+    }
+};
+
+Result drawTree(const std::shared_ptr<SyntaxTree> &tree, const RenderOptions &options)
+{
+    Result result;
+    TreeSize treeSize;
+    Layouter layouter(options);
+    if (!layouter.layout(tree->getRoot(), treeSize))
+    {
+        return result;
+    }
+
+    result.area = (options.pageMarginW * 2.0 + treeSize.xmax - treeSize.xmin) 
+                * (options.pageMarginH * 2.0 + treeSize.ymax);
+
+    // The png surface is rasterized in memory, there is no file to write.
+    Renderer renderer(tree, treeSize, "", options);
+    result.renderTime = seconds([&]() { result.drawn = renderer.drawTree(); });
+    return result;
+}
+
+int main()
+{
+    RenderOptions options;
+    options.fileType = "png";
+    Boxy boxy(options);
+
+    std::cout << "== wide-label trees, page area and png render time\n"
+              << "  label  nodes  fixed hns (area, time)   width-aware (area, time)   area ratio\n";
+    for (std::size_t maxLabel : {4, 12, 24})
+    {
+        for (std::size_t nodeCount : {200, 1000})
+        {
+            std::mt19937 rng(static_cast<unsigned>(maxLabel * 7 + nodeCount));
+            auto tree = std::make_shared<SyntaxTree>();
+            // Labels are 1 to maxLabel characters long.
+            tree->setRoot(makeTree(*tree, nodeCount, 12, 3, rng, [&]()
+            {
+                std::string s(1 + rng() % maxLabel, 'a');
+                for (auto &c : s)
+                {
+                    c = static_cast<char>('a' + rng() % 26);
+                }
+                return s;
+            }));
+
+            // Without width-aware separation the labels only stay apart if
+            // the fixed separation fits the widest label.
+            double maxWidth = 0.0;
+            std::vector<Node *> stack{tree->getRoot()};
+            while (!stack.empty())
+            {
+                auto node = stack.back();
+                stack.pop_back();
+                maxWidth = (std::max)(maxWidth, boxy.getTextBox(node->label().c_str()).width);
+                stack.insert(stack.end(), node->childArray().begin(), node->childArray().end());
+            }
+
+            auto fixedOptions = options;
+            fixedOptions.nodeHSep = (std::max)(options.nodeHSep, maxWidth + options.fontSize * 0.5);
+            auto fixed = drawTree(tree, fixedOptions);
+            auto aware = drawTree(tree, options);
+
+            std::cout << "  " << maxLabel << "\t " << nodeCount << "\t"
+                      << fixed.str() << "\t"
+                      << aware.str() << "\t"
+                      << (aware.area > 0.0 ? fixed.area / aware.area : 0.0) << "\n";
+        }
+    }
+
+    return 0;
+}
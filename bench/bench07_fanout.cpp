@@ -0,0 +1,87 @@
+/**
+ * The MIT License
+ *
+ * Copyright 2022 Krishna sssky307@163.com
+ *
+ * For the full copyright and license information, please view the LICENSE
+ * file that was distributed with this source code.
+ */
+
+#include "Layouter.h"
+#include "FlatTree.h"
+#include "BenchUtil.h"
+
+#include <iostream>
+
+using namespace cst;
+
+//
+// A root with fanOut children, each child has two leaves, so every child
+// collides with its left neighbour and is moved by MoveSubTree.
+//
+void makeWide(FlatTree &t, std::size_t fanOut)
+{
+    auto root = t.add(FlatTree::nil, 10.0);
+    for (std::size_t i = 0; i < fanOut; ++i)
+    {
+        auto child = t.add(root, 10.0);
+        t.add(child, 10.0);
+        t.add(child, 10.0);
+    }
+}
+
+//
+// A root with fanOut children where child i reaches down (trailing zero
+// bits of i) levels, with a label as wide as the children it spans, so it
+// collides with a sibling far on its left.
+//
+void makeRuler(FlatTree &t, std::size_t fanOut, double hSep)
+{
+    auto root = t.add(FlatTree::nil, 10.0);
+    for (std::size_t i = 1; i <= fanOut; ++i)
+    {
+        auto node = t.add(root, 10.0);
+        std::size_t span = 1;
+        for (auto k = i; (k & 1) == 0; k >>= 1)
+        {
+            span *= 2;
+            node = t.add(node, span * hSep * 2.0);
+        }
+    }
+}
+
+int main()
+{
+    RenderOptions options;
+    Layouter layouter(options);
+
+    for (int shape = 0; shape < 2; ++shape)
+    {
+        std::cout << (shape == 0 ? "== wide fan-out, neighbour collisions\n" 
+                                 : "== ruler fan-out, far collisions\n")
+                  << "  children   nodes     time       ns/node\n";
+        double firstNsPerNode = 0.0;
+        for (std::size_t fanOut : {12500, 25000, 50000, 100000})
+        {
+            FlatTree t;
+            if (shape == 0)
+                makeWide(t, fanOut);
+            else
+                makeRuler(t, fanOut, options.nodeHSep);
+
+            TreeSize treeSize;
+            auto time = seconds([&]() { layouter.layout(t, treeSize); });
+            auto nsPerNode = time * 1e9 / t.size();
+            if (firstNsPerNode == 0.0)
+            {
+                firstNsPerNode = nsPerNode;
+            }
+
+            std::cout << "  " << fanOut << "\t     " << t.size() << "\t"
+                      << time * 1e3 << " ms\t" << nsPerNode << " (x" 
+                      << nsPerNode / firstNsPerNode << ")\n";
+        }
+    }
+
+    return 0;
+}
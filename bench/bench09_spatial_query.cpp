@@ -0,0 +1,96 @@
+/**
+ * The MIT License
+ *
+ * Copyright 2022 Krishna sssky307@163.com
+ *
+ * For the full copyright and license information, please view the LICENSE
+ * file that was distributed with this source code.
+ */
+
+#include "Layouter.h"
+#include "SyntaxTree.h"
+#include "BenchUtil.h"
+
+#include <iostream>
+#include <random>
+
+using namespace cst;
+
+int main()
+{
+    std::cout << "  nodes     index      nodeAt/s     viewport/s   walk/s\n";
+    for (std::size_t nodes : {10000, 100000, 1000000})
+    {
+        SyntaxTree tree;
+        auto root = tree.newNode("ROOT");
+        std::mt19937 random(22);
+        while (tree.size() < nodes)
+        {
+            addPhrase(tree, root, random, 6);
+        }
+        tree.setRoot(root);
+
+        RenderOptions options;
+        Layouter layouter(options);
+        TreeSize treeSize;
+        if (!layouter.layout(root, treeSize))
+        {
+            return 1;
+        }
+
+        auto indexTime = seconds([&]() { tree.buildSpatialIndex(); });
+
+        std::uniform_real_distribution<double> x(treeSize.xmin, treeSize.xmax);
+        std::uniform_real_distribution<double> y(0.0, treeSize.ymax);
+
+        // A cursor over the tree, it may or may not be on a label.
+        std::size_t found = 0;
+        const std::size_t points = 1000000;
+        auto pointTime = seconds([&]() {
+            for (std::size_t i = 0; i < points; ++i)
+            {
+                found += tree.nodeAt(x(random), y(random)) != nullptr;
+            }
+        });
+
+        // A 1920x1080 viewport somewhere over the tree.
+        const std::size_t viewports = 10000;
+        auto viewportTime = seconds([&]() {
+            for (std::size_t i = 0; i < viewports; ++i)
+            {
+                auto x0 = x(random);
+                auto y0 = y(random);
+                found += tree.nodesIn(x0, y0, x0 + 1920.0, y0 + 1080.0).size();
+            }
+        });
+
+        // The same viewports by visiting every node.
+        const std::size_t walks = 10;
+        auto walkTime = seconds([&]() {
+            for (std::size_t i = 0; i < walks; ++i)
+            {
+                auto x0 = x(random);
+                auto y0 = y(random);
+                NodeArray stack{root};
+                while (!stack.empty())
+                {
+                    auto node = stack.back();
+                    stack.pop_back();
+                    auto &box = node->textBox();
+                    found += node->x() + box.width * 0.5 >= x0 && node->x() - box.width * 0.5 <= x0 + 1920.0
+                        && node->y() + box.height * 0.5 >= y0 && node->y() - box.height * 0.5 <= y0 + 1080.0;
+                    for (auto &child : node->childArray())
+                    {
+                        stack.push_back(child);
+                    }
+                }
+            }
+        });
+
+        std::cout << "  " << tree.size() << "\t" << indexTime * 1e3 << " ms\t"
+                  << points / pointTime << "\t" << viewports / viewportTime << "\t"
+                  << walks / walkTime << (found == 0 ? " (nothing found)\n" : "\n");
+    }
+
+    return 0;
+}
@@ -0,0 +1,65 @@
+/**
+ * The MIT License
+ *
+ * Copyright 2022 Krishna sssky307@163.com
+ *
+ * For the full copyright and license information, please view the LICENSE
+ * file that was distributed with this source code.
+ */
+
+#include "Layouter.h"
+#include "Renderer.h"
+#include "SyntaxTree.h"
+#include "BenchUtil.h"
+
+#include <cstdio>
+#include <iostream>
+#include <random>
+
+using namespace cst;
+
+int main()
+{
+    // Every tree is drawn as a 2000 pixel wide png thumbnail.
+    std::cout << "  nodes     scale      full detail   lod\n";
+    for (std::size_t nodes : {10000, 100000, 1000000})
+    {
+        auto tree = std::make_shared<SyntaxTree>();
+        auto root = tree->newNode("ROOT");
+        std::mt19937 random(23);
+        while (tree->size() < nodes)
+        {
+            addPhrase(*tree, root, random, 6);
+        }
+        tree->setRoot(root);
+
+        RenderOptions options;
+        options.fileType = "png";
+        Layouter layouter(options);
+        TreeSize treeSize;
+        if (!layouter.layout(root, treeSize))
+        {
+            return 1;
+        }
+        options.scale = 2000.0 / (treeSize.xmax - treeSize.xmin + options.pageMarginW * 2.0);
+
+        double times[2] = {};
+        for (int lod = 0; lod < 2; ++lod)
+        {
+            options.lodSize = lod == 0 ? 0.0 : 4.0;
+            Renderer renderer(tree, treeSize, "bench10_lod.png", options);
+            auto good = true;
+            times[lod] = seconds([&]() { good = renderer.drawTree(); });
+            if (!good)
+            {
+                return 1;
+            }
+        }
+        std::remove("bench10_lod.png");
+
+        std::cout << "  " << tree->size() << "\t" << options.scale << "\t"
+                  << times[0] * 1e3 << " ms\t" << times[1] * 1e3 << " ms\n";
+    }
+
+    return 0;
+}
@@ -0,0 +1,118 @@
+/**
+ * The MIT License
+ *
+ * Copyright 2022 Krishna sssky307@163.com
+ *
+ * For the full copyright and license information, please view the LICENSE
+ * file that was distributed with this source code.
+ */
+
+#include "Layouter.h"
+#include "Parser.h"
+#include "Renderer.h"
+#include "BenchUtil.h"
+
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+using namespace cst;
+
+//
+// test/data/sample4.txt, a tree with colored labels.
+//
+static const char *sample = R"~(
+[S
+    [R"(label = "while" color = "red")"]
+    [E
+        [id a]
+        [relop <]
+        [id b]
+    ]
+    [R"(label="do" color = "red")"]
+    [S1
+        [R"(label = "if" color = "red")"]
+        [E
+            [id c]
+            [relop <]
+            [id d]
+        ]
+        [R"(label = "then" color = "red")"]
+        [S1
+            [id x]
+            [=]
+            [E
+                [E
+                    [id y]
+                ]
+                [+]
+                [E
+                    [id z]
+                ]
+            ]
+        ]
+        [R"(label = "else" color = "red")"]
+        [S2
+            [id x]
+            [=]
+            [E
+                [E
+                    [id y]
+                ]
+                [-]
+                [E
+                    [id z]
+                ]
+            ]
+        ]
+    ]
+]
+)~";
+
+int main()
+{
+    // The sample repeated under one root up to about 100k nodes, scaled
+    // down to fit a page.
+    std::string buf = "[Corpus";
+    for (int i = 0; i < 2222; ++i)
+    {
+        buf += sample;
+    }
+    buf += "]";
+
+    auto tree = Parser::buildSyntaxTree(buf);
+    RenderOptions options;
+    Layouter layouter(options);
+    TreeSize treeSize;
+    if (!tree || !layouter.layout(tree->getRoot(), treeSize))
+    {
+        return 1;
+    }
+    options.scale = 20000.0 / (treeSize.xmax - treeSize.xmin + options.pageMarginW * 2.0);
+
+    std::cout << "  " << tree->size() << " nodes, scale " << options.scale << "\n"
+              << "  type   time         size\n";
+    for (auto fileType : {"svg", "pdf", "png"})
+    {
+        options.fileType = fileType;
+        auto fileName = std::string("bench11_render.") + fileType;
+        auto good = true;
+        auto time = seconds([&]() {
+            Renderer renderer(tree, treeSize, fileName, options);
+            good = renderer.drawTree();
+        });
+        if (!good)
+        {
+            return 1;
+        }
+
+        std::ifstream file(fileName, std::ios::binary | std::ios::ate);
+        std::cout << "  " << fileType << "    " << time * 1e3 << " ms\t" 
+                  << file.tellg() << " bytes\n";
+        file.close();
+        std::remove(fileName.c_str());
+    }
+
+    return 0;
+}
@@ -0,0 +1,74 @@
+/**
+ * The MIT License
+ *
+ * Copyright 2022 Krishna sssky307@163.com
+ *
+ * For the full copyright and license information, please view the LICENSE
+ * file that was distributed with this source code.
+ */
+
+#include "Arena.h"
+
+#include <algorithm>
+
+using namespace cst;
+
+constexpr std::size_t Arena::defBlockSize;
+constexpr std::size_t Arena::maxBlockSize;
+
+Arena::Arena(std::size_t blockSize)
+    : nextBlockSize_((std::max)(blockSize, sizeof(Block) * 2))
+{
+}
+
+Arena::~Arena()
+{
+    // Objects are destroyed in reverse order of creation.
+    for (auto c = cleanups_; c; c = c->next)
+    {
+        c->func(c->obj);
+    }
+
+    while (blocks_)
+    {
+        auto next = blocks_->next;
+        ::operator delete(blocks_);
+        blocks_ = next;
+    }
+}
+
+void* Arena::allocateSlow(std::size_t size, std::size_t align)
+{
+    auto need = sizeof(Block) + size + align;
+    auto dedicated = need > nextBlockSize_;
+    auto blockSize = dedicated ? need : nextBlockSize_;
+
+    auto block = static_cast<Block*>(::operator new(blockSize));
+    block->next = blocks_;
+    blocks_ = block;
+    capacity_ += blockSize;
+    ++blockCount_;
+
+    auto begin = reinterpret_cast<char*>(block) + sizeof(Block);
+    auto p = alignUp(begin, align);
+
+    // A request larger than a normal block gets a block of its own, the
+    // current block keeps serving small requests.
+    if (!dedicated)
+    {
+        cursor_ = p + size;
+        end_ = reinterpret_cast<char*>(block) + blockSize;
+        nextBlockSize_ = (std::min)(nextBlockSize_ * 2, (std::max)(nextBlockSize_, maxBlockSize));
+    }
+
+    return p;
+}
+
+void Arena::addCleanup(void* obj, void (*func)(void*))
+{
+    auto c = static_cast<Cleanup*>(allocate(sizeof(Cleanup), alignof(Cleanup)));
+    c->obj = obj;
+    c->func = func;
+    c->next = cleanups_;
+    cleanups_ = c;
+}
@@ -0,0 +1,196 @@
+/**
+ * The MIT License
+ *
+ * Copyright 2022 Krishna sssky307@163.com
+ *
+ * For the full copyright and license information, please view the LICENSE
+ * file that was distributed with this source code.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace cst
+{
+    /**
+     * @brief A monotonic (bump) allocator.
+     *
+     * Memory is carved from large blocks and is only released all at once
+     * when the arena is destroyed. Objects made by make() have their
+     * destructors run at that time, other memory is simply dropped.
+     */
+    class Arena
+    {
+    public:
+        static constexpr std::size_t defBlockSize = 64 * 1024;          ///< First block size.
+        static constexpr std::size_t maxBlockSize = 16 * 1024 * 1024;   ///< Block size stops doubling here.
+
+        /**
+         * @brief Construct an arena, no memory is allocated until it is used.
+         *
+         * @param[in] blockSize     The first block size, later blocks double
+         *                          up to maxBlockSize.
+         */
+        explicit Arena(std::size_t blockSize = defBlockSize);
+
+        /**
+         * @brief Run the registered destructors and free all blocks.
+         */
+        ~Arena();
+
+        Arena(const Arena&) = delete;
+        Arena& operator=(const Arena&) = delete;
+
+        /**
+         * @brief Allocate uninitialized memory.
+         *
+         * @param[in] size      Size in bytes.
+         * @param[in] align     Alignment, a power of two.
+         * @return void*        The memory, it lives as long as the arena.
+         */
+        void* allocate(std::size_t size, std::size_t align = alignof(std::max_align_t))
+        {
+            auto p = alignUp(cursor_, align);
+            // Aligning an odd cursor may step past the end of the block.
+            if (p != nullptr && p <= end_ && size <= static_cast<std::size_t>(end_ - p))
+            {
+                cursor_ = p + size;
+                return p;
+            }
+            return allocateSlow(size, align);
+        }
+
+        /**
+         * @brief Construct an object in the arena.
+         *
+         * Its destructor is run when the arena is destroyed, unless it is
+         * trivially destructible.
+         *
+         * @return T*   The new object.
+         */
+        template<typename T, typename... Args>
+        T* make(Args&&... args)
+        {
+            auto p = new (allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+            if (!std::is_trivially_destructible<T>::value)
+            {
+                addCleanup(p, [](void* obj) { static_cast<T*>(obj)->~T(); });
+            }
+            return p;
+        }
+
+        /**
+         * @brief Get the total size of the allocated blocks.
+         *
+         * @return std::size_t  Size in bytes.
+         */
+        std::size_t capacity()const
+        {
+            return capacity_;
+        }
+
+        /**
+         * @brief Get the number of allocated blocks.
+         *
+         * @return std::size_t  Block count.
+         */
+        std::size_t blockCount()const
+        {
+            return blockCount_;
+        }
+
+    private:
+        struct Block
+        {
+            Block* next;
+        };
+
+        struct Cleanup
+        {
+            void* obj;
+            void (*func)(void*);
+            Cleanup* next;
+        };
+
+        char* cursor_ = nullptr;
+        char* end_ = nullptr;
+        Block* blocks_ = nullptr;
+        Cleanup* cleanups_ = nullptr;
+        std::size_t nextBlockSize_;
+        std::size_t capacity_ = {};
+        std::size_t blockCount_ = {};
+
+        static char* alignUp(char* p, std::size_t align)
+        {
+            auto n = reinterpret_cast<std::size_t>(p);
+            return reinterpret_cast<char*>((n + align - 1) & ~(align - 1));
+        }
+        void* allocateSlow(std::size_t size, std::size_t align);
+        void addCleanup(void* obj, void (*func)(void*));
+    };
+
+    /**
+     * @brief A standard allocator backed by an arena.
+     *
+     * With a null arena it falls back to the heap, so containers of nodes
+     * which are not owned by any tree still free their memory.
+     */
+    template<typename T>
+    class ArenaAllocator
+    {
+    public:
+        using value_type = T;
+
+        ArenaAllocator(Arena* arena = nullptr) noexcept
+            : arena_(arena)
+        {
+        }
+
+        template<typename U>
+        ArenaAllocator(const ArenaAllocator<U>& other) noexcept
+            : arena_(other.arena())
+        {
+        }
+
+        T* allocate(std::size_t n)
+        {
+            if (arena_)
+            {
+                return static_cast<T*>(arena_->allocate(n * sizeof(T), alignof(T)));
+            }
+            return static_cast<T*>(::operator new(n * sizeof(T)));
+        }
+
+        void deallocate(T* p, std::size_t) noexcept
+        {
+            if (!arena_)
+            {
+                ::operator delete(p);
+            }
+        }
+
+        Arena* arena()const noexcept
+        {
+            return arena_;
+        }
+
+    private:
+        Arena* arena_;
+    };
+
+    template<typename T, typename U>
+    bool operator==(const ArenaAllocator<T>& a, const ArenaAllocator<U>& b) noexcept
+    {
+        return a.arena() == b.arena();
+    }
+
+    template<typename T, typename U>
+    bool operator!=(const ArenaAllocator<T>& a, const ArenaAllocator<U>& b) noexcept
+    {
+        return !(a == b);
+    }
+} // namespace cst
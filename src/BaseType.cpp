@@ -9,92 +9,86 @@
 
 #include "BaseType.h"
 
+#include <algorithm>
+#include <thread>
+
 using namespace cst;
 using namespace cst::option;
 
 //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
 // NodeSep
 //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
-double NodeSep::hSep_ = NodeSep::defHSep;
-double NodeSep::vSep_ = NodeSep::defVSep;
 bool NodeSep::isValid(double nodeSep)
 {
     return ValueBetween(nodeSep, valueMin, valueMax);
 }
 
-double NodeSep::getHSep()
-{
-    return hSep_;
-}
-
-void NodeSep::setHSep(double value)
-{
-    if(isValid(value)) hSep_ = value;
-}
-
-double NodeSep::getVSep()
-{
-    return vSep_;
-}
-
-void NodeSep::setVSep(double value)
-{
-    if(isValid(value)) vSep_ = value;
-}
-
 //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
 // FontSize
 //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
-double FontSize::fontSize_ = FontSize::defValue;
 bool FontSize::isValid(double fontSize)
 {
     return ValueBetween(fontSize, valueMin, valueMax);
 }
 
-double FontSize::getFontSize()
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// PageMargin
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+bool PageMargin::isValid(double pageMarginValue)
 {
-    return fontSize_;
+    return ValueBetween(pageMarginValue, valueMin, valueMax);
 }
 
-void FontSize::setFontSize(double value)
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// TreeDepth
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+bool TreeDepth::isValid(std::size_t treeDepth)
 {
-    if(isValid(value)) fontSize_ = value;
+    return ValueBetween(treeDepth, valueMin, valueMax);
 }
 
 //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
-// PageMargin
+// Jobs
 //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
-double PageMargin::pageMarginW_ = PageMargin::defValue;
-double PageMargin::pageMarginH_ = PageMargin::defValue;
-bool PageMargin::isValid(double pageMarginValue)
+std::size_t Jobs::valueMax()
 {
-    return ValueBetween(pageMarginValue, valueMin, valueMax);
+    // The hardware thread count may be unknown, it is 0 then.
+    std::size_t threads = (std::max)(std::thread::hardware_concurrency(), 1u);
+    return threads * 4;
 }
 
-double PageMargin::getPageMarginH()
+bool Jobs::isValid(std::size_t jobs)
 {
-    return pageMarginH_;
+    return ValueBetween(jobs, valueMin, valueMax());
 }
 
-double PageMargin::getPageMarginW()
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// TileSize
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+bool TileSize::isValid(std::size_t tileSize)
 {
-    return pageMarginW_;
+    return tileSize == 0 || ValueBetween(tileSize, valueMin, valueMax);
 }
 
-void PageMargin::setPageMarginW(double value)
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// Scale
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+bool Scale::isValid(double scale)
 {
-    if(isValid(value)) pageMarginW_ = value;
+    return ValueBetween(scale, valueMin, valueMax);
 }
 
-void PageMargin::setPageMarginH(double value)
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// LodSize
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+bool LodSize::isValid(double lodSize)
 {
-    if(isValid(value)) pageMarginH_ = value;
+    return ValueBetween(lodSize, valueMin, valueMax);
 }
 
 //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
 // FileType
 //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
-std::string FileType::fileType_ = FileType::getDefFileType();
 std::string FileType::getDefFileType()
 {
     return "pdf";
@@ -118,12 +112,19 @@ bool FileType::isValid(const std::string& fileType)
     return false;
 }
 
-std::string FileType::getFileType()
-{
-    return fileType_;
-}   
-
-void FileType::setFileType(std::string fileType)
-{
-    if(isValid(fileType)) fileType_ = fileType;
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// RenderOptions
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+bool RenderOptions::isValid() const
+{
+    return NodeSep::isValid(nodeHSep)
+        && NodeSep::isValid(nodeVSep)
+        && FontSize::isValid(fontSize)
+        && PageMargin::isValid(pageMarginW)
+        && PageMargin::isValid(pageMarginH)
+        && FileType::isValid(fileType)
+        && TreeDepth::isValid(maxTreeDepth)
+        && TileSize::isValid(tileSize)
+        && Scale::isValid(scale)
+        && LodSize::isValid(lodSize);
 }
@@ -9,18 +9,81 @@
 
 #pragma once
 
+#include "Arena.h"
+
 #include <string>
 #include <vector>
 #include <map>
+#include <cstring>
+
+#if __cplusplus >= 201703L || (defined(_MSVC_LANG) && _MSVC_LANG >= 201703L)
+#include <string_view>
+#define CST_HAS_STRING_VIEW 1
+#endif
 
 namespace cst
 {
+#ifdef CST_HAS_STRING_VIEW
+    using StrView = std::string_view;
+#else
+    //
+    // A non-owning string reference, a subset of C++17 std::string_view.
+    //
+    class StrView
+    {
+    public:
+        StrView() = default;
+        StrView(const char* data, std::size_t size) : data_(data), size_(size) {}
+        StrView(const char* str) : data_(str), size_(std::strlen(str)) {}
+        template<typename Alloc>
+        StrView(const std::basic_string<char, std::char_traits<char>, Alloc>& str) 
+            : data_(str.data()), size_(str.size()) {}
+
+        const char* data() const { return data_; }
+        std::size_t size() const { return size_; }
+        bool empty() const { return size_ == 0; }
+        const char* begin() const { return data_; }
+        const char* end() const { return data_ + size_; }
+        char operator[](std::size_t i) const { return data_[i]; }
+
+        bool operator==(StrView other) const
+        {
+            return size_ == other.size_ 
+                && (size_ == 0 || std::memcmp(data_, other.data_, size_) == 0);
+        }
+        bool operator!=(StrView other) const { return !(*this == other); }
+
+    private:
+        const char* data_ = nullptr;
+        std::size_t size_ = {};
+    };
+#endif
+
+    //
+    // FNV-1a hash of a StrView, it has no std::hash before C++17.
+    //
+    struct StrViewHash
+    {
+        std::size_t operator()(StrView str) const
+        {
+            auto hash = static_cast<std::size_t>(14695981039346656037ull);
+            for (auto c : str)
+            {
+                hash = (hash ^ static_cast<unsigned char>(c)) * static_cast<std::size_t>(1099511628211ull);
+            }
+            return hash;
+        }
+    };
+
     template<typename T1, typename T2, typename T3>
     bool ValueBetween(T1 value, T2 min, T3 max)
     {
         return min <= value && value <= max;
     }
 
+    //
+    // Option limits and defaults, the values in use are in RenderOptions.
+    //
     namespace option
     {
         class NodeSep{
@@ -30,13 +93,6 @@ namespace cst
             static constexpr double valueMin = 1.0f;
             static constexpr double valueMax = 300.0f;
             static bool isValid(double nodeSep);
-            static double getHSep();
-            static void setHSep(double value);
-            static double getVSep();
-            static void setVSep(double value);
-        private:
-            static double hSep_;
-            static double vSep_;
         };
 
         class FontSize{
@@ -45,10 +101,6 @@ namespace cst
             static constexpr double valueMin = 1.0f;
             static constexpr double valueMax = 100.0f;
             static bool isValid(double fontSize);
-            static double getFontSize();
-            static void setFontSize(double value);
-        private:
-            static double fontSize_;
         };
     
         auto constexpr defEmptyLabel = "<empty>";
@@ -59,13 +111,47 @@ namespace cst
             static constexpr double valueMin = 1.0f;
             static constexpr double valueMax = 300.0f;
             static bool isValid(double pageMarginValue);
-            static double getPageMarginW();
-            static double getPageMarginH();
-            static void setPageMarginW(double value);
-            static void setPageMarginH(double value);
-        private:
-            static double pageMarginW_;
-            static double pageMarginH_;
+        };
+
+        class TreeDepth{
+        public:
+            static constexpr std::size_t defValue = 1000000; // Default value.
+            static constexpr std::size_t valueMin = 1;
+            static constexpr std::size_t valueMax = 100000000;
+            static bool isValid(std::size_t treeDepth);
+        };
+
+        class Jobs{
+        public:
+            static constexpr std::size_t defValue = 1;  // Default value, one thread.
+            static constexpr std::size_t valueMin = 1;
+            static std::size_t valueMax();              // 4 x hardware threads.
+            static bool isValid(std::size_t jobs);
+        };
+
+        class TileSize{
+        public:
+            static constexpr std::size_t defValue = 0;      // Default value, no tiles.
+            static constexpr std::size_t autoValue = 4096;  // For a page too large for one image.
+            static constexpr std::size_t valueMin = 64;
+            static constexpr std::size_t valueMax = 32767;  // Cairo image size limit.
+            static bool isValid(std::size_t tileSize);
+        };
+
+        class Scale{
+        public:
+            static constexpr double defValue = 1.0;     // Default value, full size.
+            static constexpr double valueMin = 0.0001;
+            static constexpr double valueMax = 1.0;
+            static bool isValid(double scale);
+        };
+
+        class LodSize{
+        public:
+            static constexpr double defValue = 0.0;     // Default value, full detail.
+            static constexpr double valueMin = 0.0;
+            static constexpr double valueMax = 100.0;
+            static bool isValid(double lodSize);
         };
 
         class FileType{
@@ -73,15 +159,45 @@ namespace cst
             static std::string getDefFileType();
             static const std::vector<std::string>& getAll();
             static bool isValid(const std::string& fileType);
-            static std::string getFileType();
-            static void setFileType(std::string fileType);
-        private:
-            static std::string fileType_;
         };
     } // Common options end.
 
+    /**
+     * @brief Settings of one layout and render job.
+     * 
+     * Layouter, Boxy, Renderer and CairoContext keep a copy made on
+     * construction, jobs with different settings can run at the same time.
+     */
+    struct RenderOptions
+    {
+        double nodeHSep = option::NodeSep::defHSep;         ///< Node horizontal separation.
+        double nodeVSep = option::NodeSep::defVSep;         ///< Node vertical separation.
+        double fontSize = option::FontSize::defValue;       ///< Font size.
+        double pageMarginW = option::PageMargin::defValue;  ///< Page margin width.
+        double pageMarginH = option::PageMargin::defValue;  ///< Page margin height.
+        std::string fileType = option::FileType::getDefFileType(); ///< Output file type.
+        std::size_t maxTreeDepth = option::TreeDepth::defValue;    ///< Max tree depth.
+        std::size_t tileSize = option::TileSize::defValue;         ///< Png tile size, 0 for one image.
+        double scale = option::Scale::defValue;             ///< Output scale, below 1 for thumbnails.
+        double lodSize = option::LodSize::defValue;         ///< Label height in output pixels to draw as text, 0 for full detail.
+
+        /**
+         * @brief Check every value is in its valid range.
+         * 
+         * @return true     Valid.
+         * @return false    Invalid.
+         */
+        bool isValid()const;
+    };
+
     class Node;
     using NodeArray = std::vector<Node*>;
+
+    //
+    // Node storage, allocated from the tree arena if the node has one.
+    //
+    using String = std::basic_string<char, std::char_traits<char>, ArenaAllocator<char>>;
+    using ChildArray = std::vector<Node*, ArenaAllocator<Node*>>;
     
     //
     // A rectangle.
@@ -114,18 +230,13 @@ namespace cst
     };
 
     //
-    // Used by layout algorithm.
+    // The node position set by the layouter and read by the renderer. The
+    // layout walks keep their working fields in FlatTree.
     // 
     struct Layout
     {
-        Node* ancestor = {};
-        Node* thread = {};
-        double prelim = {};
-        double mod = {};
         double x = {};
         double y = {};
-        double shift = {};
-        double change = {};
     };
 
     //
@@ -138,28 +249,53 @@ namespace cst
     //
     struct NodeData
     {
+        NodeData(Arena* arena)
+            : label(ArenaAllocator<char>(arena)), cppRawStr(ArenaAllocator<char>(arena))
+        {
+        }
+
         std::size_t id = {};
-        std::string label;
-        std::string cppRawStr;
+        String label;
+        String cppRawStr;
         TextBox textBox;
         Layout layout;
-        Property prop;
+        Property* prop = nullptr;   ///< Only raw string nodes have property.
     };
 
     /**
      * @brief Syntax tree node definition.
+     * 
+     * A node made with an arena keeps its children, label and property in
+     * the arena, it is never deleted and is released with the arena.
+     * Otherwise it lives on the heap and is deleted one by one.
      */
     class Node
     {
     public:
-        Node(const std::string& label, const NodeArray& childArray = {})
+        Node(StrView label, const NodeArray& childArray = {}, Arena* arena = nullptr)
+            : arena_(arena), childArray_(ArenaAllocator<Node*>(arena)), data_(arena)
         {
             initNodeLabel(label);
             parent(nullptr);
-            ancestor(this);
             append(childArray);
         }
 
+        ~Node()
+        {
+            if(!arena_)
+            {
+                delete data_.prop;
+            }
+        }
+
+        Node(const Node&) = delete;
+        Node& operator=(const Node&) = delete;
+
+        Arena* arena() const
+        {
+            return arena_;
+        }
+
         void parent(Node* value)
         {
             parent_ = value;
@@ -185,7 +321,7 @@ namespace cst
             }
         }
 
-        const NodeArray& childArray() const
+        const ChildArray& childArray() const
         {
             return childArray_;
         }
@@ -205,34 +341,46 @@ namespace cst
             return data_.id;
         }
 
-        const std::string& label()const
+        const String& label()const
         {
             return data_.label;
         }
 
-        void label(std::string str)
+        void label(StrView str)
         {
-            data_.label = std::move(str);
+            data_.label.assign(str.data(), str.size());
         }
 
-        const std::string& cppRawStr()const
+        const String& cppRawStr()const
         {
             return data_.cppRawStr;
         }
 
-        void cppRawStr(std::string str)
+        void cppRawStr(StrView str)
         {
-            data_.cppRawStr = std::move(str);
+            data_.cppRawStr.assign(str.data(), str.size());
         }
 
         const Property& property() const
         {
-            return data_.prop;
+            static const Property empty;
+            return data_.prop ? *data_.prop : empty;
         }
 
         void property(Property prop)
         {
-            data_.prop = std::move(prop);
+            if(data_.prop)
+            {
+                *data_.prop = std::move(prop);
+            }
+            else if(arena_)
+            {
+                data_.prop = arena_->make<Property>(std::move(prop));
+            }
+            else
+            {
+                data_.prop = new Property(std::move(prop));
+            }
         }
 
         void textBox(TextBox textBox)
@@ -265,66 +413,6 @@ namespace cst
             return {};
         }
 
-        void prelim(double val)
-        {
-            data_.layout.prelim = val;
-        }
-
-        double prelim() const
-        {
-            return data_.layout.prelim;
-        }
-
-        void mod(double val)
-        {
-            data_.layout.mod = val;
-        }
-
-        double mod() const
-        {
-            return data_.layout.mod;
-        }
-
-        void thread(Node* v)
-        {
-            data_.layout.thread = v;
-        }
-
-        Node* thread() const
-        {
-            return data_.layout.thread;
-        }
-
-        void ancestor(Node* v)
-        {
-            data_.layout.ancestor = v;
-        }
-
-        Node* ancestor() const
-        {
-            return data_.layout.ancestor;
-        }
-
-        void change(double val)
-        {
-            data_.layout.change = val;
-        }
-
-        double change() const
-        {
-            return data_.layout.change;
-        }
-
-        void shift(double val)
-        {
-            data_.layout.shift = val;
-        }
-
-        double shift() const
-        {
-            return data_.layout.shift;
-        }
-
         void x(double val)
         {
             data_.layout.x = val;
@@ -346,10 +434,11 @@ namespace cst
         }
 
     private:
+        Arena* arena_;
         Node* parent_;
-        NodeArray childArray_;  
+        ChildArray childArray_;  
         NodeData data_;
-        void initNodeLabel(const std::string& label)
+        void initNodeLabel(StrView label)
         {
             if(label.empty())
             {
@@ -357,7 +446,7 @@ namespace cst
             }
             else
             {
-                data_.label = label;
+                data_.label.assign(label.data(), label.size());
             }
         }
     };
@@ -10,22 +10,79 @@
 #include "Boxy.h"
 #include "CairoContext.h"
 #include "SyntaxTree.h"
+#include "FlatTree.h"
 
 using namespace cst;
 
-Boxy::Boxy(double fontSize)
+Boxy::Boxy(const RenderOptions& options, TextBoxCachePtr cache, GlyphMetricsPtr metrics)
+    : cache_(cache), metrics_(metrics), fontSize_(options.fontSize)
 {
-    ctx_ = std::make_shared<CairoContext>(fontSize);
+    if(!metrics_)
+    {
+        ctx_ = std::make_shared<CairoContext>(options);
+        fontFace_ = ctx_->fontFace();
+    }
+    else
+    {
+        fontFace_ = metrics_->fontFace();
+    }
+    if(!cache_)
+    {
+        cache_ = std::make_shared<TextBoxCache>();
+    }
 }
 
 bool Boxy::good()const
 {
-     return ctx_->good();
+    if(metrics_)
+    {
+        return metrics_->good() && metrics_->fontSize() == fontSize_;
+    }
+    return ctx_->good();
+}
+
+const TextBoxCachePtr& Boxy::cache()const
+{
+    return cache_;
 }
 
-TextBox Boxy::getTextBox(std::string text)
+const GlyphMetricsPtr& Boxy::metrics()const
 {
-    if(!ctx_->good() || text.empty()) return {};
+    return metrics_;
+}
+
+TextBox Boxy::getTextBox(StrView text)
+{
+    if(!good() || text.empty()) return {};
+
+    TextBox textBox;
+    if(!cache_->find(text, fontSize_, fontFace_, textBox))
+    {
+        textBox = measure(std::string(text.data(), text.size()));
+        cache_->insert(text, fontSize_, fontFace_, textBox);
+    }
+
+    return textBox;
+}
+
+TextBox Boxy::getTextBox(const std::string& text)
+{
+    return getTextBox(StrView(text));
+}
+
+TextBox Boxy::getTextBox(const char* text)
+{
+    if(text == nullptr) return {};
+
+    return getTextBox(StrView(text));
+}
+
+TextBox Boxy::measure(const std::string& text)
+{
+    if(metrics_)
+    {
+        return metrics_->getTextBox(text);
+    }
 
     TextBox textBox;
     cairo_text_extents_t extents;
@@ -47,20 +104,43 @@ bool Boxy::initTextBox(Node* t)
     return internalInitTextBox(t);
 }
 
+bool Boxy::initTextBox(FlatTree& t, std::size_t begin, std::size_t end)
+{
+    if(!good() || end > t.node.size()) return false;
+
+    for(auto i = begin; i < end; ++i)
+    {
+        auto v = t.node[i];
+        v->textBox(getTextBox(StrView(v->label())));
+        t.width[i] = v->textBox().width;
+    }
+
+    return true;
+}
+
 bool Boxy::internalInitTextBox(Node* t)
 {
-    if(t != nullptr && !t->label().empty())
+    NodeArray stack;
+    if(t != nullptr)
     {
-        for(auto& child: t->childArray())
+        stack.push_back(t);
+    }
+
+    while(!stack.empty())
+    {
+        auto node = stack.back();
+        stack.pop_back();
+        if(node->label().empty())
+        {
+            return false;
+        }
+
+        node->textBox(getTextBox(StrView(node->label())));
+        for(auto& child: node->childArray())
         {
-            if(!internalInitTextBox(child))
-            {
-                return false;
-            }
+            stack.push_back(child);
         }
-        t->textBox(getTextBox(t->label()));
-        return true;
     }
 
-    return false;
+    return t != nullptr;
 }
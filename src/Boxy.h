@@ -10,6 +10,8 @@
 #pragma once
 
 #include "BaseType.h"
+#include "TextBoxCache.h"
+#include "GlyphMetrics.h"
 
 #include <string>
 #include <memory>
@@ -19,6 +21,7 @@ namespace cst
     class CairoContext;
     using CairoContextPtr = std::shared_ptr<CairoContext>;
     class Node;
+    class FlatTree;
 
     /**
      * @brief Used to calculate string's textbox for layouting.
@@ -29,9 +32,16 @@ namespace cst
         /**
          * @brief Construct a new Boxy object
          * 
-         * @param[in] fontSize  Font size used to calculate textbox.
+         * @param[in] options   The font size is used to calculate textbox.
+         * @param[in] cache     A textbox cache which may be shared with other
+         *                      Boxy objects, a private one is made if nullptr.
+         * @param[in] metrics   Glyph metrics of the same font size which may be
+         *                      shared with other Boxy objects. If nullptr, the
+         *                      text is measured by a private cairo context.
          */
-        Boxy(double fontSize = option::FontSize::getFontSize());
+        explicit Boxy(const RenderOptions& options = RenderOptions(),
+                      TextBoxCachePtr cache = nullptr,
+                      GlyphMetricsPtr metrics = nullptr);
         /**
          * @brief Check this object state is ok or not.
          * 
@@ -41,6 +51,16 @@ namespace cst
          * @return false    Not ok.
          */
         bool good()const;
+        /**
+         * @brief Calculate text's textbox.
+         * 
+         * A text is measured once, then it is taken from the cache.
+         * 
+         * @param[in] text      Input string.
+         * 
+         * @return TextBox      Output the string's textbox.
+         */
+        TextBox getTextBox(StrView text);
         /**
          * @brief Calculate text's textbox.
          * 
@@ -48,7 +68,15 @@ namespace cst
          * 
          * @return TextBox      Output the string's textbox.
          */
-        TextBox getTextBox(std::string text);
+        TextBox getTextBox(const std::string& text);
+        /**
+         * @brief Calculate text's textbox.
+         * 
+         * @param[in] text      Input null terminated string.
+         * 
+         * @return TextBox      Output the string's textbox.
+         */
+        TextBox getTextBox(const char* text);
         /**
          * @brief Init a three's all node's label's textbox.
          * 
@@ -57,9 +85,39 @@ namespace cst
          * @return false    Work fail.
          */
         bool initTextBox(Node* t);
+        /**
+         * @brief Init the label textboxes and widths of a range of flat tree nodes.
+         * 
+         * Different ranges of one tree can be measured at the same time by
+         * different Boxy objects.
+         * 
+         * @param[in,out] t     A flat tree made from nodes.
+         * @param[in] begin     The first node index.
+         * @param[in] end       One past the last node index.
+         * @return true         Work pass.
+         * @return false        Work fail.
+         */
+        bool initTextBox(FlatTree& t, std::size_t begin, std::size_t end);
+        /**
+         * @brief Get the textbox cache.
+         * 
+         * @return TextBoxCachePtr  The cache, it is never nullptr.
+         */
+        const TextBoxCachePtr& cache()const;
+        /**
+         * @brief Get the glyph metrics.
+         * 
+         * @return GlyphMetricsPtr  The metrics, nullptr if measuring by cairo.
+         */
+        const GlyphMetricsPtr& metrics()const;
 
     private:
         CairoContextPtr ctx_;
+        TextBoxCachePtr cache_;
+        GlyphMetricsPtr metrics_;
+        double fontSize_;
+        std::string fontFace_;
         bool internalInitTextBox(Node* t);
+        TextBox measure(const std::string& text);
     };
 }
@@ -13,23 +13,22 @@ using namespace cst;
 
 CairoContext::CairoContext(double width,
                            double height,
-                           std::string fileType,
                            std::string fileName,
-                           double fontSize)
+                           const RenderOptions& options)
     : width_{width},
       height_{height},
-      fileType_{fileType},
+      fileType_{options.fileType},
       fileName_{fileName},
-      fontSize_{fontSize}
+      fontSize_{options.fontSize}
 {
     good_ = init();
 }
 
-CairoContext::CairoContext(double fontSize)
+CairoContext::CairoContext(const RenderOptions& options)
     : width_{10.0f},
       height_{10.0f},
       fileType_{"png"},
-      fontSize_(fontSize)
+      fontSize_(options.fontSize)
 {
     good_ = init();
 }
@@ -49,6 +48,32 @@ cairo_t *const &CairoContext::cr() const
     return cr_;
 }
 
+std::string CairoContext::fontFace() const
+{
+    if (!good_)
+        return {};
+
+    auto face = cairo_get_font_face(cr_);
+    if (face == nullptr || cairo_font_face_get_type(face) != CAIRO_FONT_TYPE_TOY)
+        return {};
+
+    auto family = cairo_toy_font_face_get_family(face);
+    return family ? family : "";
+}
+
+bool CairoContext::setPageSize(double width, double height)
+{
+    if (!good_ || fileType_ != "pdf" || width <= 1.0f || height <= 1.0f)
+    {
+        return false;
+    }
+
+    cairo_pdf_surface_set_size(cs_, width, height);
+    width_ = width;
+    height_ = height;
+    return true;
+}
+
 CairoContext::~CairoContext()
 {
     if (cr_)
@@ -32,22 +32,20 @@ namespace cst
          * 
          * @param[in] width     Page width.
          * @param[in] height    Page height.
-         * @param[in] fileType  Specify output file type.
          * @param[in] fileName  Specify output file name.
-         * @param[in] fontSize  Font size.
+         * @param[in] options   Output file type and font size.
          */
         CairoContext(double width, 
                      double height,
-                     std::string fileType, 
                      std::string fileName,
-                     double fontSize = option::FontSize::getFontSize());
+                     const RenderOptions& options = RenderOptions());
 
         /**
-         * @brief Construct a new Cairo Context object
+         * @brief Construct a new Cairo Context object for measuring text.
          * 
-         * @param[in] fontSize  Font size.
+         * @param[in] options   Font size.
          */
-        CairoContext(double fontSize = option::FontSize::getFontSize());
+        explicit CairoContext(const RenderOptions& options = RenderOptions());
 
         /**
          * @brief Destroy the Cairo Context object
@@ -77,6 +75,27 @@ namespace cst
          */
         cairo_t* const& cr()const;
 
+        /**
+         * @brief Resize the pages drawn from now on.
+         * 
+         * Only a pdf surface can change its page size, so one pdf context
+         * can hold many pages of different sizes.
+         * 
+         * @param[in] width     Page width.
+         * @param[in] height    Page height.
+         * 
+         * @return true         Pass.
+         * @return false        Fail, the context is not pdf or the size is invalid.
+         */
+        bool setPageSize(double width, double height);
+
+        /**
+         * @brief Get the font face family the text is drawn with.
+         * 
+         * @return std::string  The family, it is empty if unknown.
+         */
+        std::string fontFace()const;
+
     private:
         cairo_t* cr_ = nullptr;
         cairo_surface_t* cs_ = nullptr;
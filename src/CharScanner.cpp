@@ -0,0 +1,309 @@
+/**
+ * The MIT License
+ *
+ * Copyright 2022 Krishna sssky307@163.com
+ *
+ * For the full copyright and license information, please view the LICENSE
+ * file that was distributed with this source code.
+ */
+
+#include "CharScanner.h"
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define CST_SCAN_X86 1
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#define CST_TARGET_SSE2
+#define CST_TARGET_AVX2
+#else
+#define CST_TARGET_SSE2 __attribute__((target("sse2")))
+#define CST_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#endif
+
+using namespace cst;
+
+const bool CharScanner::spaceTable[256] = {
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 0, 1, 1, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0
+};
+
+const bool CharScanner::labelTable[256] = {
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 1, 0, 1, 1,
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 0
+};
+
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// Scalar
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+static const uint8_t* scalarSkipSpace(const uint8_t* p, const uint8_t* end)
+{
+    while(p < end && CharScanner::isSpace(*p)) ++p;
+    return p;
+}
+
+static const uint8_t* scalarSkipLabel(const uint8_t* p, const uint8_t* end)
+{
+    while(p < end && CharScanner::isLabel(*p)) ++p;
+    return p;
+}
+
+static const uint8_t* scalarFindRawStop(const uint8_t* p, const uint8_t* end)
+{
+    while(p < end && *p != ')' && *p != '"') ++p;
+    return p;
+}
+
+#ifdef CST_SCAN_X86
+
+static inline unsigned countTrailingZeros(uint32_t mask)
+{
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanForward(&index, mask);
+    return index;
+#else
+    return __builtin_ctz(mask);
+#endif
+}
+
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// SSE2
+//
+// A byte x is in [lo, lo + span] if min(x - lo, span) == x - lo,
+// all in unsigned 8 bit arithmetic.
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+CST_TARGET_SSE2 static inline __m128i sse2InRange(__m128i x, uint8_t lo, uint8_t span)
+{
+    auto t = _mm_sub_epi8(x, _mm_set1_epi8((char)lo));
+    return _mm_cmpeq_epi8(_mm_min_epu8(t, _mm_set1_epi8((char)span)), t);
+}
+
+// Space: 0x09, 0x0A, 0x0C, 0x0D and 0x20.
+CST_TARGET_SSE2 static inline __m128i sse2IsSpace(__m128i x)
+{
+    auto ctrl = _mm_andnot_si128(_mm_cmpeq_epi8(x, _mm_set1_epi8(0x0B)), sse2InRange(x, 0x09, 0x04));
+    return _mm_or_si128(ctrl, _mm_cmpeq_epi8(x, _mm_set1_epi8(0x20)));
+}
+
+// Label: 0x21~0x7E and 0xA0~0xFD except '[' and ']'.
+CST_TARGET_SSE2 static inline __m128i sse2IsLabel(__m128i x)
+{
+    auto range = _mm_or_si128(sse2InRange(x, 0x21, 0x5D), sse2InRange(x, 0xA0, 0x5D));
+    auto square = _mm_or_si128(_mm_cmpeq_epi8(x, _mm_set1_epi8('[')), _mm_cmpeq_epi8(x, _mm_set1_epi8(']')));
+    return _mm_andnot_si128(square, range);
+}
+
+CST_TARGET_SSE2 static inline __m128i sse2IsRawStop(__m128i x)
+{
+    return _mm_or_si128(_mm_cmpeq_epi8(x, _mm_set1_epi8(')')), _mm_cmpeq_epi8(x, _mm_set1_epi8('"')));
+}
+
+CST_TARGET_SSE2 static const uint8_t* sse2SkipSpace(const uint8_t* p, const uint8_t* end)
+{
+    for(; end - p >= 16; p += 16)
+    {
+        auto x = _mm_loadu_si128((const __m128i*)p);
+        uint32_t stop = ~_mm_movemask_epi8(sse2IsSpace(x)) & 0xFFFF;
+        if(stop) return p + countTrailingZeros(stop);
+    }
+    return scalarSkipSpace(p, end);
+}
+
+CST_TARGET_SSE2 static const uint8_t* sse2SkipLabel(const uint8_t* p, const uint8_t* end)
+{
+    for(; end - p >= 16; p += 16)
+    {
+        auto x = _mm_loadu_si128((const __m128i*)p);
+        uint32_t stop = ~_mm_movemask_epi8(sse2IsLabel(x)) & 0xFFFF;
+        if(stop) return p + countTrailingZeros(stop);
+    }
+    return scalarSkipLabel(p, end);
+}
+
+CST_TARGET_SSE2 static const uint8_t* sse2FindRawStop(const uint8_t* p, const uint8_t* end)
+{
+    for(; end - p >= 16; p += 16)
+    {
+        auto x = _mm_loadu_si128((const __m128i*)p);
+        uint32_t stop = _mm_movemask_epi8(sse2IsRawStop(x));
+        if(stop) return p + countTrailingZeros(stop);
+    }
+    return scalarFindRawStop(p, end);
+}
+
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// AVX2, the same tests 32 bytes at a time.
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+CST_TARGET_AVX2 static inline __m256i avx2InRange(__m256i x, uint8_t lo, uint8_t span)
+{
+    auto t = _mm256_sub_epi8(x, _mm256_set1_epi8((char)lo));
+    return _mm256_cmpeq_epi8(_mm256_min_epu8(t, _mm256_set1_epi8((char)span)), t);
+}
+
+CST_TARGET_AVX2 static inline __m256i avx2IsSpace(__m256i x)
+{
+    auto ctrl = _mm256_andnot_si256(_mm256_cmpeq_epi8(x, _mm256_set1_epi8(0x0B)), avx2InRange(x, 0x09, 0x04));
+    return _mm256_or_si256(ctrl, _mm256_cmpeq_epi8(x, _mm256_set1_epi8(0x20)));
+}
+
+CST_TARGET_AVX2 static inline __m256i avx2IsLabel(__m256i x)
+{
+    auto range = _mm256_or_si256(avx2InRange(x, 0x21, 0x5D), avx2InRange(x, 0xA0, 0x5D));
+    auto square = _mm256_or_si256(_mm256_cmpeq_epi8(x, _mm256_set1_epi8('[')), _mm256_cmpeq_epi8(x, _mm256_set1_epi8(']')));
+    return _mm256_andnot_si256(square, range);
+}
+
+CST_TARGET_AVX2 static inline __m256i avx2IsRawStop(__m256i x)
+{
+    return _mm256_or_si256(_mm256_cmpeq_epi8(x, _mm256_set1_epi8(')')), _mm256_cmpeq_epi8(x, _mm256_set1_epi8('"')));
+}
+
+CST_TARGET_AVX2 static const uint8_t* avx2SkipSpace(const uint8_t* p, const uint8_t* end)
+{
+    for(; end - p >= 32; p += 32)
+    {
+        auto x = _mm256_loadu_si256((const __m256i*)p);
+        uint32_t stop = ~(uint32_t)_mm256_movemask_epi8(avx2IsSpace(x));
+        if(stop) return p + countTrailingZeros(stop);
+    }
+    return sse2SkipSpace(p, end);
+}
+
+CST_TARGET_AVX2 static const uint8_t* avx2SkipLabel(const uint8_t* p, const uint8_t* end)
+{
+    for(; end - p >= 32; p += 32)
+    {
+        auto x = _mm256_loadu_si256((const __m256i*)p);
+        uint32_t stop = ~(uint32_t)_mm256_movemask_epi8(avx2IsLabel(x));
+        if(stop) return p + countTrailingZeros(stop);
+    }
+    return sse2SkipLabel(p, end);
+}
+
+CST_TARGET_AVX2 static const uint8_t* avx2FindRawStop(const uint8_t* p, const uint8_t* end)
+{
+    for(; end - p >= 32; p += 32)
+    {
+        auto x = _mm256_loadu_si256((const __m256i*)p);
+        uint32_t stop = (uint32_t)_mm256_movemask_epi8(avx2IsRawStop(x));
+        if(stop) return p + countTrailingZeros(stop);
+    }
+    return sse2FindRawStop(p, end);
+}
+
+static bool cpuHasAvx2()
+{
+#ifdef _MSC_VER
+    int info[4];
+    __cpuid(info, 0);
+    if(info[0] < 7) return false;
+    __cpuid(info, 1);
+    bool osxsave = (info[2] & (1 << 27)) != 0;
+    bool avx = (info[2] & (1 << 28)) != 0;
+    if(!osxsave || !avx || (_xgetbv(0) & 0x6) != 0x6) return false;
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+
+#endif // CST_SCAN_X86
+
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// CharScanner
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+CharScanner::Level CharScanner::bestLevel()
+{
+    static const Level level = []()
+    {
+#ifdef CST_SCAN_X86
+#if defined(__i386__) || defined(_M_IX86)
+        // SSE2 is not part of the 32 bit baseline.
+#ifdef _MSC_VER
+        int info[4];
+        __cpuid(info, 1);
+        if((info[3] & (1 << 26)) == 0) return Level::Scalar;
+#else
+        if(!__builtin_cpu_supports("sse2")) return Level::Scalar;
+#endif
+#endif
+        return cpuHasAvx2() ? Level::AVX2 : Level::SSE2;
+#else
+        return Level::Scalar;
+#endif
+    }();
+
+    return level;
+}
+
+const char* CharScanner::levelName(Level level)
+{
+    switch(level)
+    {
+    case Level::SSE2: return "sse2";
+    case Level::AVX2: return "avx2";
+    default: return "scalar";
+    }
+}
+
+CharScanner::CharScanner(Level level)
+{
+    if(static_cast<int>(level) > static_cast<int>(bestLevel()))
+    {
+        level = bestLevel();
+    }
+
+    level_ = level;
+    switch(level)
+    {
+#ifdef CST_SCAN_X86
+    case Level::AVX2:
+        skipSpace_ = avx2SkipSpace;
+        skipLabel_ = avx2SkipLabel;
+        findRawStop_ = avx2FindRawStop;
+        break;
+    case Level::SSE2:
+        skipSpace_ = sse2SkipSpace;
+        skipLabel_ = sse2SkipLabel;
+        findRawStop_ = sse2FindRawStop;
+        break;
+#endif
+    default:
+        level_ = Level::Scalar;
+        skipSpace_ = scalarSkipSpace;
+        skipLabel_ = scalarSkipLabel;
+        findRawStop_ = scalarFindRawStop;
+        break;
+    }
+}
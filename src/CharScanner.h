@@ -0,0 +1,122 @@
+/**
+ * The MIT License
+ *
+ * Copyright 2022 Krishna sssky307@163.com
+ *
+ * For the full copyright and license information, please view the LICENSE
+ * file that was distributed with this source code.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+
+namespace cst
+{
+    /**
+     * @brief Skip runs of lexer characters many bytes at a time.
+     *
+     * Every scan function looks at [begin, end) and returns the first byte
+     * that stops the run, or end if there is none. The SSE2(16 bytes) and
+     * AVX2(32 bytes) variants are picked at runtime and agree with the scalar
+     * tables byte for byte.
+     */
+    class CharScanner
+    {
+    public:
+        /**
+         * @brief Instruction set used by the scan functions.
+         */
+        enum class Level : int
+        {
+            Scalar = 0,     ///< One byte at a time.
+            SSE2,           ///< 16 bytes at a time.
+            AVX2            ///< 32 bytes at a time.
+        };
+
+        using ScanFunc = const uint8_t* (*)(const uint8_t* begin, const uint8_t* end);
+
+        /**
+         * @brief Get the best level the running cpu supports.
+         *
+         * @return Level    The best level, it is detected once.
+         */
+        static Level bestLevel();
+
+        /**
+         * @brief Get the level name for logging.
+         *
+         * @param[in] level     A level.
+         * @return const char*  The name.
+         */
+        static const char* levelName(Level level);
+
+        /**
+         * @brief Construct a scanner.
+         *
+         * @param[in] level     Wanted level, it falls back to the best
+         *                      supported level if the cpu lacks it.
+         */
+        CharScanner(Level level = bestLevel());
+
+        /**
+         * @brief Get the level in use.
+         *
+         * @return Level    The level.
+         */
+        Level level()const
+        {
+            return level_;
+        }
+
+        /**
+         * @brief Find the first non-space character.
+         */
+        const uint8_t* skipSpace(const uint8_t* begin, const uint8_t* end)const
+        {
+            return skipSpace_(begin, end);
+        }
+
+        /**
+         * @brief Find the first character which can not be in a basic string label.
+         */
+        const uint8_t* skipLabel(const uint8_t* begin, const uint8_t* end)const
+        {
+            return skipLabel_(begin, end);
+        }
+
+        /**
+         * @brief Find the first ')' or '"', which may end a C++ raw string.
+         */
+        const uint8_t* findRawStop(const uint8_t* begin, const uint8_t* end)const
+        {
+            return findRawStop_(begin, end);
+        }
+
+        /**
+         * @brief Checks whether ch is a space character.
+         */
+        static bool isSpace(uint8_t ch)
+        {
+            return spaceTable[ch];
+        }
+
+        /**
+         * @brief Checks whether ch is a non control/space/square character.
+         */
+        static bool isLabel(uint8_t ch)
+        {
+            return labelTable[ch];
+        }
+
+    private:
+        Level level_;
+        ScanFunc skipSpace_;
+        ScanFunc skipLabel_;
+        ScanFunc findRawStop_;
+
+        static const bool spaceTable[256];
+        static const bool labelTable[256];
+    };
+} // namespace cst
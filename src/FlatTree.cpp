@@ -0,0 +1,160 @@
+/**
+ * The MIT License
+ *
+ * Copyright 2022 Krishna sssky307@163.com
+ *
+ * For the full copyright and license information, please view the LICENSE
+ * file that was distributed with this source code.
+ */
+
+#include "FlatTree.h"
+
+#include <atomic>
+
+using namespace cst;
+
+constexpr FlatTree::Index FlatTree::nil;
+
+FlatTree::FlatTree(Node* t)
+{
+    assign(t);
+}
+
+std::uint64_t FlatTree::newGeneration()
+{
+    static std::atomic<std::uint64_t> next{1};
+    return next.fetch_add(1, std::memory_order_relaxed);
+}
+
+void FlatTree::assign(Node* t)
+{
+    clear();
+    if (t == nullptr)
+    {
+        return;
+    }
+
+    // Preorder, children are pushed in reverse. Only the nodes, parents and
+    // widths are collected here, the other arrays are filled at once below.
+    std::vector<std::pair<Node*, Index>> stack{{t, nil}};
+    while (!stack.empty())
+    {
+        auto v = stack.back().first;
+        auto p = stack.back().second;
+        stack.pop_back();
+
+        auto i = static_cast<Index>(node.size());
+        node.push_back(v);
+        parent.push_back(p);
+        width.push_back(v->textBox().width);
+
+        auto& childArray = v->childArray();
+        for (auto it = childArray.rbegin(); it != childArray.rend(); ++it)
+        {
+            stack.emplace_back(*it, i);
+        }
+    }
+
+    auto count = node.size();
+    for (auto a : {&firstChild, &lastChild, &nextSibling, &prevSibling, &thread})
+    {
+        a->assign(count, nil);
+    }
+    depth.assign(count, 0);
+    number.assign(count, 0);
+    for (auto a : {&x, &y, &prelim, &mod, &shift, &change})
+    {
+        a->assign(count, 0.0);
+    }
+    ancestor.resize(count);
+
+    for (Index i = 0; i < count; ++i)
+    {
+        ancestor[i] = i;
+        link(i);
+    }
+}
+
+void FlatTree::clear()
+{
+    generation_ = newGeneration();
+    for (auto a : {&parent, &firstChild, &lastChild, &nextSibling, &prevSibling,
+                   &depth, &number, &thread, &ancestor})
+    {
+        a->clear();
+    }
+    for (auto a : {&width, &x, &y, &prelim, &mod, &shift, &change})
+    {
+        a->clear();
+    }
+    node.clear();
+}
+
+void FlatTree::reserve(std::size_t count)
+{
+    for (auto a : {&parent, &firstChild, &lastChild, &nextSibling, &prevSibling,
+                   &depth, &number, &thread, &ancestor})
+    {
+        a->reserve(count);
+    }
+    for (auto a : {&width, &x, &y, &prelim, &mod, &shift, &change})
+    {
+        a->reserve(count);
+    }
+}
+
+FlatTree::Index FlatTree::add(Index parentIndex, double nodeWidth)
+{
+    auto i = static_cast<Index>(size());
+
+    parent.push_back(parentIndex);
+    firstChild.push_back(nil);
+    lastChild.push_back(nil);
+    nextSibling.push_back(nil);
+    prevSibling.push_back(nil);
+    depth.push_back(0);
+    number.push_back(0);
+
+    width.push_back(nodeWidth);
+    x.push_back(0.0);
+    y.push_back(0.0);
+    prelim.push_back(0.0);
+    mod.push_back(0.0);
+    shift.push_back(0.0);
+    change.push_back(0.0);
+    thread.push_back(nil);
+    ancestor.push_back(i);
+
+    link(i);
+    return i;
+}
+
+void FlatTree::link(Index i)
+{
+    auto p = parent[i];
+    if (p != nil)
+    {
+        depth[i] = depth[p] + 1;
+        auto last = lastChild[p];
+        if (last == nil)
+        {
+            firstChild[p] = i;
+        }
+        else
+        {
+            nextSibling[last] = i;
+            prevSibling[i] = last;
+            number[i] = number[last] + 1;
+        }
+        lastChild[p] = i;
+    }
+}
+
+void FlatTree::copyPositionToNode()const
+{
+    for (std::size_t i = 0; i < node.size(); ++i)
+    {
+        node[i]->x(x[i]);
+        node[i]->y(y[i]);
+    }
+}
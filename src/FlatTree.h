@@ -0,0 +1,132 @@
+/**
+ * The MIT License
+ *
+ * Copyright 2022 Krishna sssky307@163.com
+ *
+ * For the full copyright and license information, please view the LICENSE
+ * file that was distributed with this source code.
+ */
+
+#pragma once
+
+#include "BaseType.h"
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace cst
+{
+    /**
+     * @brief An index based (structure of arrays) copy of a tree for layout.
+     *
+     * Node i of the tree is entry i of every array. A parent always has a
+     * smaller index than its children, a tree made from a Node is indexed
+     * in preorder, the same as the node ids of a SyntaxTree. The layout
+     * walks only pull the arrays they use into cache, instead of a whole
+     * Node per visit.
+     */
+    class FlatTree
+    {
+    public:
+        using Index = std::uint32_t;
+        static constexpr Index nil = UINT32_MAX;    ///< No such node.
+
+        FlatTree() = default;
+
+        /**
+         * @brief Make a flat copy of a tree.
+         *
+         * @param[in] t     The tree root, the widths are taken from the
+         *                  node textboxes.
+         */
+        explicit FlatTree(Node* t);
+
+        /**
+         * @brief Replace the content with a flat copy of a tree.
+         *
+         * @param[in] t     The tree root.
+         */
+        void assign(Node* t);
+
+        /**
+         * @brief Remove all nodes.
+         */
+        void clear();
+
+        /**
+         * @brief Reserve memory for nodes.
+         *
+         * @param[in] count     The node count.
+         */
+        void reserve(std::size_t count);
+
+        /**
+         * @brief Append a node as the last child of its parent.
+         *
+         * @param[in] parentIndex   The parent, or nil for the root.
+         * @param[in] nodeWidth     The node label width.
+         * @return Index            The new node.
+         */
+        Index add(Index parentIndex, double nodeWidth = {});
+
+        /**
+         * @brief Get the node count.
+         *
+         * @return std::size_t  The node count.
+         */
+        std::size_t size()const
+        {
+            return parent.size();
+        }
+
+        /**
+         * @brief Get the generation, a new one is taken by assign() and clear().
+         *
+         * Generations are unique in the process, so a tree made where another
+         * one was freed does not look like it.
+         *
+         * @return std::uint64_t    The generation.
+         */
+        std::uint64_t generation()const
+        {
+            return generation_;
+        }
+
+        /**
+         * @brief Write the layout positions back to the source nodes.
+         */
+        void copyPositionToNode()const;
+
+        // Tree structure.
+        std::vector<Index> parent;
+        std::vector<Index> firstChild;
+        std::vector<Index> lastChild;
+        std::vector<Index> nextSibling;
+        std::vector<Index> prevSibling;
+        std::vector<Index> depth;
+        std::vector<Index> number;      ///< Position among the siblings, from 0.
+
+        // Layout input and output.
+        std::vector<double> width;
+        std::vector<double> x;
+        std::vector<double> y;
+
+        // Layout algorithm state.
+        std::vector<double> prelim;
+        std::vector<double> mod;
+        std::vector<double> shift;
+        std::vector<double> change;
+        std::vector<Index> thread;
+        std::vector<Index> ancestor;
+
+        // The source nodes, empty if the tree is built by add().
+        std::vector<Node*> node;
+
+    private:
+        std::uint64_t generation_ = newGeneration();
+
+        static std::uint64_t newGeneration();
+        void link(Index i);
+    };
+} // namespace cst
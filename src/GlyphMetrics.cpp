@@ -0,0 +1,292 @@
+/**
+ * The MIT License
+ *
+ * Copyright 2022 Krishna sssky307@163.com
+ *
+ * For the full copyright and license information, please view the LICENSE
+ * file that was distributed with this source code.
+ */
+
+#include "GlyphMetrics.h"
+#include "CairoContext.h"
+
+#include <algorithm>
+
+using namespace cst;
+
+constexpr uint32_t GlyphMetrics::asciiBegin;
+constexpr uint32_t GlyphMetrics::asciiEnd;
+constexpr uint32_t GlyphMetrics::asciiCount;
+constexpr std::size_t GlyphMetrics::shardCount;
+
+namespace
+{
+    // Decode one codepoint at p, return false if it is not valid utf-8.
+    // Overlong forms and surrogates are not valid, cairo rejects them too.
+    bool decodeUtf8(const uint8_t*& p, const uint8_t* end, uint32_t& codepoint)
+    {
+        static const uint32_t minCodepoint[] = {0, 0x80, 0x800, 0x10000};
+
+        uint32_t c = *p++;
+        int more = 0;
+        if (c < 0x80)
+        {
+            codepoint = c;
+            return true;
+        }
+        else if ((c & 0xE0) == 0xC0)
+        {
+            c &= 0x1F;
+            more = 1;
+        }
+        else if ((c & 0xF0) == 0xE0)
+        {
+            c &= 0x0F;
+            more = 2;
+        }
+        else if ((c & 0xF8) == 0xF0)
+        {
+            c &= 0x07;
+            more = 3;
+        }
+        else
+        {
+            return false;
+        }
+
+        auto minimum = minCodepoint[more];
+        while (more-- > 0)
+        {
+            if (p == end || (*p & 0xC0) != 0x80)
+                return false;
+            c = (c << 6) | (*p++ & 0x3F);
+        }
+
+        codepoint = c;
+        return minimum <= c && c <= 0x10FFFF && (c < 0xD800 || c > 0xDFFF);
+    }
+
+    void appendUtf8(uint32_t c, std::string& s)
+    {
+        if (c < 0x80)
+        {
+            s += static_cast<char>(c);
+        }
+        else if (c < 0x800)
+        {
+            s += static_cast<char>(0xC0 | (c >> 6));
+            s += static_cast<char>(0x80 | (c & 0x3F));
+        }
+        else if (c < 0x10000)
+        {
+            s += static_cast<char>(0xE0 | (c >> 12));
+            s += static_cast<char>(0x80 | ((c >> 6) & 0x3F));
+            s += static_cast<char>(0x80 | (c & 0x3F));
+        }
+        else
+        {
+            s += static_cast<char>(0xF0 | (c >> 18));
+            s += static_cast<char>(0x80 | ((c >> 12) & 0x3F));
+            s += static_cast<char>(0x80 | ((c >> 6) & 0x3F));
+            s += static_cast<char>(0x80 | (c & 0x3F));
+        }
+    }
+
+    // Get the glyphs of text at the origin, the caller frees them.
+    int textToGlyphs(cairo_scaled_font_t* font, const std::string& text, cairo_glyph_t*& glyphs)
+    {
+        glyphs = nullptr;
+        int count = 0;
+        auto status = cairo_scaled_font_text_to_glyphs(font, 0.0, 0.0, 
+                                                       text.data(), static_cast<int>(text.size()),
+                                                       &glyphs, &count, 
+                                                       nullptr, nullptr, nullptr);
+        return status == CAIRO_STATUS_SUCCESS ? count : 0;
+    }
+}
+
+GlyphMetrics::GlyphMetrics(const RenderOptions& options)
+    : fontSize_(options.fontSize)
+{
+    // The context is only needed to pick the font, it is dropped right away.
+    CairoContext ctx(options);
+    if (!ctx.good())
+        return;
+
+    auto font = cairo_get_scaled_font(ctx.cr());
+    if (font == nullptr || cairo_scaled_font_status(font) != CAIRO_STATUS_SUCCESS)
+        return;
+    font_ = cairo_scaled_font_reference(font);
+    fontFace_ = ctx.fontFace();
+
+    for (auto c = asciiBegin; c < asciiEnd; ++c)
+    {
+        ascii_[c - asciiBegin] = loadGlyph(c);
+    }
+    for (auto first = asciiBegin; first < asciiEnd; ++first)
+    {
+        for (auto second = asciiBegin; second < asciiEnd; ++second)
+        {
+            asciiPairs_[(first - asciiBegin) * asciiCount + second - asciiBegin] = loadPair(first, second);
+        }
+    }
+}
+
+GlyphMetrics::~GlyphMetrics()
+{
+    if (font_)
+    {
+        cairo_scaled_font_destroy(font_);
+    }
+}
+
+bool GlyphMetrics::good()const
+{
+    return font_ != nullptr;
+}
+
+GlyphMetrics::Glyph GlyphMetrics::loadGlyph(uint32_t codepoint)
+{
+    Glyph g;
+    std::string text;
+    appendUtf8(codepoint, text);
+
+    cairo_glyph_t* glyphs;
+    auto count = textToGlyphs(font_, text, glyphs);
+    if (count > 0)
+    {
+        cairo_text_extents_t extents;
+        cairo_scaled_font_glyph_extents(font_, glyphs, count, &extents);
+        g.ink.width = extents.width;
+        g.ink.height = extents.height;
+        g.ink.xBearing = extents.x_bearing;
+        g.ink.yBearing = extents.y_bearing;
+        g.xAdvance = extents.x_advance;
+        g.yAdvance = extents.y_advance;
+    }
+    cairo_glyph_free(glyphs);
+
+    return g;
+}
+
+GlyphMetrics::Offset GlyphMetrics::loadPair(uint32_t first, uint32_t second)
+{
+    std::string text;
+    appendUtf8(first, text);
+    appendUtf8(second, text);
+
+    Offset offset;
+    cairo_glyph_t* glyphs;
+    if (textToGlyphs(font_, text, glyphs) == 2)
+    {
+        offset.x = glyphs[1].x - glyphs[0].x;
+        offset.y = glyphs[1].y - glyphs[0].y;
+    }
+    else
+    {
+        offset.x = glyph(first).xAdvance;
+        offset.y = glyph(first).yAdvance;
+    }
+    cairo_glyph_free(glyphs);
+
+    return offset;
+}
+
+GlyphMetrics::Glyph GlyphMetrics::glyph(uint32_t codepoint)
+{
+    if (codepoint >= asciiBegin && codepoint < asciiEnd)
+        return ascii_[codepoint - asciiBegin];
+
+    // Loaded out of the lock, a racing thread loads the same value.
+    auto& shard = shards_[codepoint % shardCount];
+    {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        auto it = shard.glyphs.find(codepoint);
+        if (it != shard.glyphs.end())
+            return it->second;
+    }
+
+    auto g = loadGlyph(codepoint);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    return shard.glyphs.emplace(codepoint, g).first->second;
+}
+
+GlyphMetrics::Offset GlyphMetrics::pair(uint32_t first, uint32_t second)
+{
+    if (first >= asciiBegin && first < asciiEnd && second >= asciiBegin && second < asciiEnd)
+        return asciiPairs_[(first - asciiBegin) * asciiCount + second - asciiBegin];
+
+    auto key = (static_cast<uint64_t>(first) << 32) | second;
+    auto& shard = shards_[(first ^ second) % shardCount];
+    {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        auto it = shard.pairs.find(key);
+        if (it != shard.pairs.end())
+            return it->second;
+    }
+
+    auto offset = loadPair(first, second);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    return shard.pairs.emplace(key, offset).first->second;
+}
+
+TextBox GlyphMetrics::getTextBox(const std::string& text)
+{
+    if (!good() || text.empty())
+        return {};
+
+    auto p = reinterpret_cast<const uint8_t*>(text.data());
+    auto end = p + text.size();
+
+    // The ink box of the whole text, the pen starts at the origin.
+    double x0 = 0.0, y0 = 0.0, x1 = 0.0, y1 = 0.0;
+    double penX = 0.0, penY = 0.0;
+    bool hasInk = false;
+    uint32_t prev = 0;
+
+    for (bool first = true; p != end; first = false)
+    {
+        uint32_t c;
+        if (!decodeUtf8(p, end, c))
+            return {};
+
+        if (!first)
+        {
+            auto offset = pair(prev, c);
+            penX += offset.x;
+            penY += offset.y;
+        }
+        prev = c;
+
+        auto ink = glyph(c).ink;
+        if (ink.width == 0.0 || ink.height == 0.0)
+            continue;
+
+        auto left = penX + ink.xBearing;
+        auto top = penY + ink.yBearing;
+        auto right = left + ink.width;
+        auto bottom = top + ink.height;
+        if (!hasInk)
+        {
+            x0 = left, y0 = top, x1 = right, y1 = bottom;
+            hasInk = true;
+        }
+        else
+        {
+            x0 = (std::min)(x0, left);
+            y0 = (std::min)(y0, top);
+            x1 = (std::max)(x1, right);
+            y1 = (std::max)(y1, bottom);
+        }
+    }
+
+    TextBox textBox;
+    if (hasInk)
+    {
+        textBox.width = x1 - x0;
+        textBox.height = y1 - y0;
+        textBox.xBearing = x0;
+        textBox.yBearing = y0;
+    }
+    return textBox;
+}
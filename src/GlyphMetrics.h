@@ -0,0 +1,131 @@
+/**
+ * The MIT License
+ *
+ * Copyright 2022 Krishna sssky307@163.com
+ *
+ * For the full copyright and license information, please view the LICENSE
+ * file that was distributed with this source code.
+ */
+
+#pragma once
+
+#include "BaseType.h"
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+typedef struct _cairo_scaled_font cairo_scaled_font_t;
+
+namespace cst
+{
+    /**
+     * @brief Measure text from cached per-glyph metrics.
+     *
+     * The advance and ink box of a codepoint are read from a cairo scaled
+     * font once, the printable ascii ones when constructed. The pen offset
+     * between two codepoints is read once per pair too, so it includes the
+     * kerning of the font. A textbox is then the union of the glyph ink boxes
+     * along the pen, without any cairo surface or cairo_t per call. It agrees
+     * with cairo_text_extents up to rounding.
+     *
+     * It is thread-safe, one object can be shared by all threads. The
+     * printable ascii glyphs and pairs are loaded when constructed and read
+     * without a lock, other codepoints are kept in shards which are locked
+     * separately.
+     */
+    class GlyphMetrics
+    {
+    public:
+        /**
+         * @brief Load the font metrics.
+         *
+         * @param[in] options   The font size.
+         */
+        explicit GlyphMetrics(const RenderOptions& options = RenderOptions());
+
+        ~GlyphMetrics();
+
+        GlyphMetrics(const GlyphMetrics&) = delete;
+        GlyphMetrics& operator=(const GlyphMetrics&) = delete;
+
+        /**
+         * @brief Check the font is loaded.
+         *
+         * @return true     Ok.
+         * @return false    Not ok.
+         */
+        bool good()const;
+
+        /**
+         * @brief Calculate text's textbox.
+         *
+         * @param[in] text      Input utf-8 string.
+         *
+         * @return TextBox      Output the string's textbox, it is empty if
+         *                      the text is not valid utf-8.
+         */
+        TextBox getTextBox(const std::string& text);
+
+        /**
+         * @brief Get the font size.
+         */
+        double fontSize()const
+        {
+            return fontSize_;
+        }
+
+        /**
+         * @brief Get the font face family, it is empty if unknown.
+         */
+        const std::string& fontFace()const
+        {
+            return fontFace_;
+        }
+
+    private:
+        struct Glyph
+        {
+            TextBox ink;            ///< Ink box relative to the pen.
+            double xAdvance = {};
+            double yAdvance = {};
+        };
+
+        struct Offset
+        {
+            double x = {};
+            double y = {};
+        };
+
+        static constexpr uint32_t asciiBegin = 0x20;
+        static constexpr uint32_t asciiEnd = 0x7F;
+        static constexpr uint32_t asciiCount = asciiEnd - asciiBegin;
+        static constexpr std::size_t shardCount = 16;
+
+        struct Shard
+        {
+            std::mutex mutex;                   ///< Guards the maps below.
+            std::unordered_map<uint32_t, Glyph> glyphs;
+            std::unordered_map<uint64_t, Offset> pairs;
+        };
+
+        cairo_scaled_font_t* font_ = nullptr;
+        double fontSize_;
+        std::string fontFace_;
+
+        // Read only after construction.
+        Glyph ascii_[asciiCount];
+        Offset asciiPairs_[asciiCount * asciiCount];  ///< By first * asciiCount + second.
+
+        Shard shards_[shardCount];
+
+        Glyph loadGlyph(uint32_t codepoint);
+        Offset loadPair(uint32_t first, uint32_t second);
+        Glyph glyph(uint32_t codepoint);
+        Offset pair(uint32_t first, uint32_t second);
+    };
+
+    using GlyphMetricsPtr = std::shared_ptr<GlyphMetrics>;
+} // namespace cst
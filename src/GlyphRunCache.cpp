@@ -0,0 +1,40 @@
+/**
+ * The MIT License
+ *
+ * Copyright 2022 Krishna sssky307@163.com
+ *
+ * For the full copyright and license information, please view the LICENSE
+ * file that was distributed with this source code.
+ */
+
+#include "GlyphRunCache.h"
+
+using namespace cst;
+
+const GlyphRunCache::Glyphs& GlyphRunCache::glyphs(cairo_scaled_font_t* font, 
+                                                   StrView fontFace, 
+                                                   double fontSize, 
+                                                   StrView text)
+{
+    LabelKey key{text, fontFace, fontSize};
+    auto found = runs_.find(key);
+    if (found)
+    {
+        return *found;
+    }
+
+    Glyphs run;
+    cairo_glyph_t* glyphs = nullptr;
+    int count = 0;
+    auto status = cairo_scaled_font_text_to_glyphs(font, 0.0, 0.0, 
+                                                   text.data(), static_cast<int>(text.size()),
+                                                   &glyphs, &count, 
+                                                   nullptr, nullptr, nullptr);
+    if (status == CAIRO_STATUS_SUCCESS && count > 0)
+    {
+        run.assign(glyphs, glyphs + count);
+    }
+    cairo_glyph_free(glyphs);
+
+    return *runs_.emplace(key, std::move(run)).first;
+}
@@ -0,0 +1,64 @@
+/**
+ * The MIT License
+ *
+ * Copyright 2022 Krishna sssky307@163.com
+ *
+ * For the full copyright and license information, please view the LICENSE
+ * file that was distributed with this source code.
+ */
+
+#pragma once
+
+#include "CairoContext.h"
+#include "LabelMap.h"
+
+#include <memory>
+#include <vector>
+
+namespace cst
+{
+    /**
+     * @brief A cache of the glyphs of labels.
+     *
+     * A label is converted to glyphs by the cairo scaled font only the first
+     * time it is drawn, the glyphs are kept at the origin and moved to each
+     * node position. The glyph indexes and positions belong to one font face
+     * and size, so they are a part of the key. One cache can be kept for a
+     * whole job and used by the renderers of its trees one after another.
+     * It is not thread-safe.
+     *
+     * A label is looked up by a view of it, only a new label is copied.
+     */
+    class GlyphRunCache
+    {
+    public:
+        using Glyphs = std::vector<cairo_glyph_t>;
+
+        /**
+         * @brief Get the glyphs of a label.
+         *
+         * @param[in] font          The font to convert a new label with.
+         * @param[in] fontFace      The font face family of font.
+         * @param[in] fontSize      The font size of font.
+         * @param[in] text          The utf-8 label.
+         *
+         * @return const Glyphs&    The glyphs with the pen starting at the
+         *                          origin, empty if the label can not be
+         *                          converted.
+         */
+        const Glyphs& glyphs(cairo_scaled_font_t* font, StrView fontFace, double fontSize, StrView text);
+
+        /**
+         * @brief Get the number of cached labels.
+         */
+        std::size_t size()const
+        {
+            return runs_.size();
+        }
+
+    private:
+        LabelMap<Glyphs> runs_;
+    };
+
+    using GlyphRunCachePtr = std::shared_ptr<GlyphRunCache>;
+} // namespace cst
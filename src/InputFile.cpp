@@ -0,0 +1,159 @@
+/**
+ * The MIT License
+ *
+ * Copyright 2022 Krishna sssky307@163.com
+ *
+ * For the full copyright and license information, please view the LICENSE
+ * file that was distributed with this source code.
+ */
+
+#include "InputFile.h"
+
+#include <algorithm>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+
+#ifdef _WIN32
+#include <io.h>
+#define CST_OPEN(name) _open(name, _O_RDONLY | _O_BINARY)
+#define CST_READ _read
+#define CST_CLOSE _close
+#else
+#include <sys/mman.h>
+#include <unistd.h>
+#include <cerrno>
+#define CST_OPEN(name) open(name, O_RDONLY)
+#define CST_READ read
+#define CST_CLOSE close
+#endif
+
+using namespace cst;
+
+InputFile::InputFile(const std::string& fileName)
+{
+    good_ = init(fileName);
+}
+
+InputFile::~InputFile()
+{
+#ifndef _WIN32
+    if (mapping_)
+    {
+        munmap(mapping_, size_);
+    }
+#endif
+}
+
+bool InputFile::good() const
+{
+    return good_;
+}
+
+const uint8_t* InputFile::data() const
+{
+    return data_;
+}
+
+std::size_t InputFile::size() const
+{
+    return size_;
+}
+
+bool InputFile::isMapped() const
+{
+    return mapping_ != nullptr;
+}
+
+bool InputFile::isRegularFile(const std::string& fileName)
+{
+#ifdef _WIN32
+    struct _stat64 st;
+    return _stat64(fileName.c_str(), &st) == 0 && (st.st_mode & _S_IFREG);
+#else
+    struct stat st;
+    return stat(fileName.c_str(), &st) == 0 && S_ISREG(st.st_mode);
+#endif
+}
+
+bool InputFile::init(const std::string& fileName)
+{
+    if (fileName.empty())
+    {
+        return false;
+    }
+
+    int fd = CST_OPEN(fileName.c_str());
+    if (fd < 0)
+    {
+        return false;
+    }
+
+    bool ok = false;
+
+#ifndef _WIN32
+    struct stat st;
+    if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0)
+    {
+        auto mapping = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapping != MAP_FAILED)
+        {
+            // The lexer walks the input front to back only once.
+            madvise(mapping, st.st_size, MADV_SEQUENTIAL);
+            mapping_ = mapping;
+            data_ = static_cast<const uint8_t*>(mapping);
+            size_ = static_cast<std::size_t>(st.st_size);
+            ok = true;
+        }
+    }
+#endif
+
+    // Pipes, devices, empty files or a failed mmap.
+    if (!ok)
+    {
+        ok = readAll(fd);
+    }
+
+    CST_CLOSE(fd);
+    return ok;
+}
+
+bool InputFile::readAll(int fd)
+{
+    static constexpr std::size_t chunkSize = 64 * 1024;
+
+    std::size_t used = 0;
+    while (true)
+    {
+        if (buffer_.size() - used < chunkSize)
+        {
+            buffer_.resize(buffer_.size() + (std::max)(chunkSize, buffer_.size()));
+        }
+
+        auto n = CST_READ(fd, buffer_.data() + used, static_cast<unsigned>(chunkSize));
+        if (n > 0)
+        {
+            used += static_cast<std::size_t>(n);
+        }
+        else if (n == 0)
+        {
+            break;
+        }
+#ifndef _WIN32
+        else if (errno == EINTR)
+        {
+            continue;
+        }
+#endif
+        else
+        {
+            return false;
+        }
+    }
+
+    buffer_.resize(used);
+    buffer_.shrink_to_fit();
+    data_ = buffer_.data();
+    size_ = buffer_.size();
+    return true;
+}
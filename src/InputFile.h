@@ -0,0 +1,95 @@
+/**
+ * The MIT License
+ *
+ * Copyright 2022 Krishna sssky307@163.com
+ *
+ * For the full copyright and license information, please view the LICENSE
+ * file that was distributed with this source code.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace cst
+{
+    /**
+     * @brief A read-only view of a whole input file.
+     *
+     * Regular files are memory-mapped so the lexer can scan the mapped pages
+     * directly without copying them. Pipes, character devices and systems
+     * without mmap fall back to reading the stream into an owned buffer.
+     */
+    class InputFile
+    {
+    public:
+        /**
+         * @brief Open and map (or read) the input file.
+         *
+         * @param[in] fileName  The input file name.
+         */
+        InputFile(const std::string& fileName);
+
+        /**
+         * @brief Unmap or free the file content.
+         */
+        ~InputFile();
+
+        InputFile(const InputFile&) = delete;
+        InputFile& operator=(const InputFile&) = delete;
+
+        /**
+         * @brief Check the file is opened and its content is available.
+         *
+         * @return true     Ok.
+         * @return false    Not ok.
+         */
+        bool good()const;
+
+        /**
+         * @brief Get the file content begin.
+         *
+         * @return const uint8_t*   Content begin, it may be nullptr if size() is 0.
+         */
+        const uint8_t* data()const;
+
+        /**
+         * @brief Get the file content size.
+         *
+         * @return std::size_t  Content size in bytes.
+         */
+        std::size_t size()const;
+
+        /**
+         * @brief Check the content is memory-mapped or read into a buffer.
+         *
+         * @return true     Memory-mapped.
+         * @return false    Read into a buffer.
+         */
+        bool isMapped()const;
+
+        /**
+         * @brief Check a file name refers to a regular file.
+         *
+         * Pipes, character devices and stdin are not regular, they are better
+         * parsed as a stream than read into memory as a whole.
+         *
+         * @param[in] fileName  The file name.
+         *
+         * @return true     A regular file.
+         * @return false    Not a regular file or it cannot be stat'ed.
+         */
+        static bool isRegularFile(const std::string& fileName);
+
+    private:
+        const uint8_t* data_ = nullptr;
+        std::size_t size_ = {};
+        void* mapping_ = nullptr;       ///< Mapped address, nullptr if not mapped.
+        std::vector<uint8_t> buffer_;   ///< Fallback storage for unmappable input.
+        bool good_ = false;
+        bool init(const std::string& fileName);
+        bool readAll(int fd);
+    };
+} // namespace cst
@@ -0,0 +1,136 @@
+/**
+ * The MIT License
+ *
+ * Copyright 2022 Krishna sssky307@163.com
+ *
+ * For the full copyright and license information, please view the LICENSE
+ * file that was distributed with this source code.
+ */
+
+#pragma once
+
+#include "BaseType.h"
+
+#include <cstddef>
+#include <deque>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+namespace cst
+{
+    /**
+     * @brief A label measured or drawn with a font face and size.
+     *
+     * A lookup key views the caller's strings, a key stored in a LabelMap
+     * views the strings owned by the map.
+     */
+    struct LabelKey
+    {
+        // LabelMap rebinds the views of a stored key to an equal copy, it
+        // changes neither the hash nor the equality.
+        mutable StrView label;
+        mutable StrView fontFace;
+        double fontSize;
+
+        bool operator==(const LabelKey& other)const
+        {
+            return fontSize == other.fontSize && label == other.label && fontFace == other.fontFace;
+        }
+    };
+
+    struct LabelKeyHash
+    {
+        std::size_t operator()(const LabelKey& key)const
+        {
+            return StrViewHash()(key.label)
+                ^ (StrViewHash()(key.fontFace) * 31)
+                ^ (std::hash<double>()(key.fontSize) * 131);
+        }
+    };
+
+    /**
+     * @brief A map from LabelKey to T which owns the strings of its keys.
+     *
+     * A lookup does not copy the label, the strings of a key are only
+     * copied when the key is new. It is not thread-safe.
+     */
+    template<typename T>
+    class LabelMap
+    {
+    public:
+        using Map = std::unordered_map<LabelKey, T, LabelKeyHash>;
+        using const_iterator = typename Map::const_iterator;
+
+        /**
+         * @brief Find a value.
+         *
+         * @param[in] key       The key, it may view any strings.
+         *
+         * @return T*           The value, or nullptr if not found.
+         */
+        T* find(const LabelKey& key)
+        {
+            auto it = map_.find(key);
+            return it == map_.end() ? nullptr : &it->second;
+        }
+
+        /**
+         * @brief Add a value if the key is not found.
+         *
+         * @param[in] key       The key, it may view any strings.
+         * @param[in] value     The value.
+         *
+         * @return The value in the map, and true if it is added or false if
+         *         the key is found and the value is not used.
+         */
+        std::pair<T*, bool> emplace(const LabelKey& key, T value)
+        {
+            auto result = map_.emplace(key, std::move(value));
+            if (result.second)
+            {
+                intern(result.first);
+            }
+            return {&result.first->second, result.second};
+        }
+
+        std::size_t size()const { return map_.size(); }
+        const_iterator begin()const { return map_.begin(); }
+        const_iterator end()const { return map_.end(); }
+
+        void clear()
+        {
+            map_.clear();
+            strings_.clear();
+        }
+
+    private:
+        // Own a copy of the strings of a new key, the key views it from now on.
+        void intern(typename Map::iterator it)
+        {
+            auto& key = it->first;
+            try
+            {
+                std::string str;
+                str.reserve(key.fontFace.size() + key.label.size());
+                str.append(key.fontFace.data(), key.fontFace.size());
+                str.append(key.label.data(), key.label.size());
+                strings_.push_back(std::move(str));
+            }
+            catch (...)
+            {
+                // The key still views the caller's strings.
+                map_.erase(it);
+                throw;
+            }
+
+            // A deque keeps the strings in place, so the keys stay valid.
+            auto& str = strings_.back();
+            key.label = StrView(str.data() + key.fontFace.size(), key.label.size());
+            key.fontFace = StrView(str.data(), key.fontFace.size());
+        }
+
+        std::deque<std::string> strings_;   ///< Font face and label of each key, one string per key.
+        Map map_;
+    };
+} // namespace cst
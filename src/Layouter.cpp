@@ -9,10 +9,14 @@
 
 #include "Layouter.h"
 #include "SyntaxTree.h"
+#include "FlatTree.h"
 #include "Boxy.h"
+#include "ThreadPool.h"
 
+#include <atomic>
 #include <limits>
 #include <algorithm>
+#include <vector>
 
 #define assert_true(x) assert(x)
 
@@ -30,17 +34,17 @@ public:
         xMax = std::numeric_limits<double>::min();
         yMax = std::numeric_limits<double>::min();
     }
-    void update(const Node* const v)
+    void update(double x, double y, double width)
     {
-        auto xmin = v->x();
-        auto xmax = v->x() + v->textBox().width;
-        auto ymax = v->y();
+        auto xmin = x;
+        auto xmax = x + width;
+        auto ymax = y;
 
         if(xmin < xMin)
         {
             xMin = xmin;
             // Patch for align page center when do renderering.
-            xMin2 = xmin - v->textBox().width * 0.5;
+            xMin2 = xmin - width * 0.5;
         }
 
         if(xmax > xMax) xMax = xmax;
@@ -59,91 +63,281 @@ private:
     double yMax = {};
 };
 
-Helper gHelper;
-
 //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
 // Layouter implementation.
 //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
-Layouter::Layouter(double fontSize, double nodeHSep, double nodeVSep)
-    :boxy_{new Boxy(fontSize)}, nodeHSep_{nodeHSep}, nodeVSep_{nodeVSep}
+Layouter::Layouter(const RenderOptions& options, TextBoxCachePtr cache, GlyphMetricsPtr metrics)
+    :options_(options), boxy_{new Boxy(options, cache, metrics)}
+{
+}
+
+void Layouter::setThreadPool(ThreadPool* pool)
+{
+    pool_ = pool;
+    workerBoxy_.clear();
+}
+
+bool Layouter::measure(FlatTree& t)
+{
+    // Small trees are not worth waking the pool.
+    static constexpr std::size_t chunkSize = 4096;
+
+    auto chunkCount = (t.size() + chunkSize - 1) / chunkSize;
+    if(pool_ == nullptr || pool_->size() == 1 || chunkCount < 2)
+    {
+        return boxy_->initTextBox(t, 0, t.size());
+    }
+
+    workerBoxy_.resize(pool_->size());
+    workerBoxy_[0] = boxy_;
+
+    std::atomic<bool> good{true};
+    pool_->parallelFor(chunkCount, [&](std::size_t index, std::size_t worker)
+    {
+        auto& boxy = workerBoxy_[worker];
+        if(!boxy)
+        {
+            boxy = std::make_shared<Boxy>(options_, boxy_->cache(), boxy_->metrics());
+        }
+
+        auto begin = index * chunkSize;
+        auto end = (std::min)(begin + chunkSize, t.size());
+        if(!boxy->initTextBox(t, begin, end))
+        {
+            good = false;
+        }
+    });
+
+    return good;
+}
+
+bool Layouter::remeasure(FlatTree& t, FlatTree::Index i)
 {
+    if(i >= t.node.size()) return false;
+
+    return boxy_->initTextBox(t, i, i + 1);
 }
 
 bool Layouter::layout(Node* t, TreeSize& treeSize)
 {
     if(!boxy_->good()) return false;
-    gHelper.init();
 
-    FirstWalk(t, *boxy_);
-    SecondWalk(t, (-1.0) * t->prelim());
+    FlatTree flat(t);
+    if(!measure(flat)) return false;
 
-    gHelper.output(treeSize);
+    if(!layout(flat, treeSize)) return false;
 
+    flat.copyPositionToNode();
     return true;
 }
 
-void Layouter::FirstWalk(Node *v, Boxy& boxy, Node *leftSibingOfV)
+bool Layouter::layout(FlatTree& t, TreeSize& treeSize)
 {
-    // Initialize node label's textbox.
-    v->textBox(boxy.getTextBox(v->label()));
+    if(t.size() == 0) return false;
+
+    // Reset the algorithm state, a tree can be laid out again.
+    std::fill(t.prelim.begin(), t.prelim.end(), 0.0);
+    std::fill(t.mod.begin(), t.mod.end(), 0.0);
+    std::fill(t.shift.begin(), t.shift.end(), 0.0);
+    std::fill(t.change.begin(), t.change.end(), 0.0);
+    std::fill(t.thread.begin(), t.thread.end(), FlatTree::nil);
+    for(std::size_t i = 0; i < t.size(); ++i)
+    {
+        t.ancestor[i] = static_cast<Index>(i);
+    }
+    if(&t == journalTree_ && t.generation() == journalGeneration_)
+    {
+        journal_.clear();
+    }
+
+    FirstWalk(t);
+    SecondWalk(t);
 
-    if (!v->isLeaf())
+    // Preorder, the same visiting order as the recursive SecondWalk.
+    Helper helper;
+    helper.init();
+    for(std::size_t i = 0; i < t.size(); ++i)
     {
-        auto dac = v->leftMostChild();
+        helper.update(t.x[i], t.y[i], t.width[i]);
+    }
+    helper.output(treeSize);
 
-        Node *leftSibingOfChild = nullptr;
-        for (auto &child : v->childArray())
-        {
-            FirstWalk(child, boxy, leftSibingOfChild);
-            dac = Apportion(child, leftSibingOfChild, dac);
-            leftSibingOfChild = child;
-        }
+    return true;
+}
 
-        ExecuteShifts(v);
+bool Layouter::relayout(FlatTree& t, FlatTree::Index changed, TreeSize& treeSize)
+{
+    if(t.size() == 0 || (changed != FlatTree::nil && changed >= t.size())) return false;
 
-        auto midpoint = (v->leftMostChild()->prelim() 
-                        + v->rightMostChild()->prelim()
-                        ) * 0.5;
+    //
+    // Placing the children of v writes only inside the subtree of v, and
+    // reads only what the walks of its descendants left there. So after
+    // an edit only the nodes above it must be placed again: their writes
+    // are undone from the root down, which brings back the state every
+    // untouched subtree had right after its own walk, then they are
+    // walked again from the edit up. New nodes have no state to undo.
+    //
+    if(&t != journalTree_ || t.generation() != journalGeneration_ || journal_.size() > t.size())
+    {
+        journal_.clear();
+        journalTree_ = &t;
+        journalGeneration_ = t.generation();
+    }
+    auto known = static_cast<Index>(journal_.size());
+    journal_.resize(t.size());
 
-        if (leftSibingOfV)
+    std::vector<uint8_t> dirty(t.size(), 0);
+    std::vector<Index> path;
+    auto mark = [&](Index v)
+    {
+        for(; v != FlatTree::nil && !dirty[v]; v = t.parent[v])
         {
-            v->prelim(leftSibingOfV->prelim() + nodeHSep_);
-            //v->prelim(leftSibingOfV->prelim() + Distance(leftSibingOfV));
-            v->mod(v->prelim() - midpoint);
+            dirty[v] = 1;
+            path.push_back(v);
         }
-        else
+    };
+    mark(changed);
+    for(auto i = known; i < t.size(); ++i)
+    {
+        mark(i);
+    }
+    // A parent has a smaller index than its children.
+    std::sort(path.begin(), path.end());
+
+    std::vector<Index> touched(path);
+    for(auto v : path)
+    {
+        auto& journal = journal_[v];
+        for(auto it = journal.rbegin(); it != journal.rend(); ++it)
         {
-            v->prelim(midpoint);
+            if(it->kind == Write::Kind::Real)
+            {
+                (t.*(it->array.real))[it->node] = it->value.real;
+            }
+            else
+            {
+                (t.*(it->array.link))[it->node] = it->value.link;
+            }
+            touched.push_back(it->node);
         }
+        journal.clear();
     }
-    else
+
+    for(auto i = known; i < t.size(); ++i)
+    {
+        t.prelim[i] = t.mod[i] = t.shift[i] = t.change[i] = 0.0;
+        t.thread[i] = FlatTree::nil;
+        t.ancestor[i] = i;
+    }
+
+    for(auto it = path.rbegin(); it != path.rend(); ++it)
     {
-        if (leftSibingOfV)
+        if(t.firstChild[*it] == FlatTree::nil) continue;
+
+        writes_ = &journal_[*it];
+        PlaceChildren(t, *it);
+        for(auto& write : *writes_)
         {
-            v->prelim(leftSibingOfV->prelim() + nodeHSep_);
-            //v->prelim(leftSibingOfV->prelim() + Distance(leftSibingOfV));
+            touched.push_back(write.node);
         }
-        else
+        writes_ = nullptr;
+    }
+
+    std::sort(touched.begin(), touched.end());
+    touched_ = std::unique(touched.begin(), touched.end()) - touched.begin();
+
+    // One moved subtree moves every node right of it, the final positions
+    // are a single cheap pass.
+    SecondWalk(t);
+
+    Helper helper;
+    helper.init();
+    for(std::size_t i = 0; i < t.size(); ++i)
+    {
+        helper.update(t.x[i], t.y[i], t.width[i]);
+    }
+    helper.output(treeSize);
+
+    return true;
+}
+
+std::size_t Layouter::touched()const
+{
+    return touched_;
+}
+
+void Layouter::FirstWalk(FlatTree& t)
+{
+    //
+    // Children have larger indexes than their parent, so walking the indexes
+    // backwards finishes every subtree before its root.
+    //
+    // A subtree does not depend on its siblings until it is placed next to
+    // them, so the part of the recursive FirstWalk which runs after the
+    // recursion is done here when the parent is visited: each child is
+    // placed right of its left sibling and apportioned, in child order.
+    // A non-leaf child keeps its children midpoint in prelim until then.
+    //
+    for(auto v = static_cast<Index>(t.size()); v-- > 0;)
+    {
+        if(t.firstChild[v] != FlatTree::nil)
         {
-            // v->prelim(0.0f);
+            PlaceChildren(t, v);
         }
     }
 }
 
-void Layouter::SecondWalk(Node *v, double m, size_t level)
+void Layouter::PlaceChildren(FlatTree& t, Index v)
 {
-    v->x(v->prelim() + m);
-    v->y(level * nodeVSep_);
+    auto dac = t.firstChild[v];
+    auto leftSibingOfChild = FlatTree::nil;
+    for(auto child = t.firstChild[v]; child != FlatTree::nil; child = t.nextSibling[child])
+    {
+        if(leftSibingOfChild != FlatTree::nil)
+        {
+            auto midpoint = t.prelim[child];
+            SetState(t, &FlatTree::prelim, child, t.prelim[leftSibingOfChild] + Distance(t, leftSibingOfChild, child));
+            if(t.firstChild[child] != FlatTree::nil)
+            {
+                SetState(t, &FlatTree::mod, child, t.prelim[child] - midpoint);
+            }
+        }
 
-    gHelper.update(v);
+        dac = Apportion(t, child, leftSibingOfChild, dac);
+        leftSibingOfChild = child;
+    }
+
+    ExecuteShifts(t, v);
+
+    auto midpoint = (t.prelim[t.firstChild[v]]
+                    + t.prelim[t.lastChild[v]]
+                    ) * 0.5;
+    SetState(t, &FlatTree::prelim, v, midpoint);
+}
+
+void Layouter::SecondWalk(FlatTree& t)
+{
+    //
+    // Parents come first, m of a node is the mod sum of its ancestors, it
+    // is kept per node to leave the mods untouched.
+    //
+    std::vector<double> m(t.size());
+    m[0] = (-1.0) * t.prelim[0];
 
-    for (auto &child : v->childArray())
+    for(std::size_t v = 0; v < t.size(); ++v)
     {
-        SecondWalk(child, m + v->mod(), level + 1);
+        auto p = t.parent[v];
+        if(p != FlatTree::nil)
+        {
+            m[v] = m[p] + t.mod[p];
+        }
+
+        t.x[v] = t.prelim[v] + m[v];
+        t.y[v] = t.depth[v] * options_.nodeVSep;
     }
 }
 
-Node* Layouter::Apportion(Node *v, Node *leftSibingOfV, Node *dac)
+FlatTree::Index Layouter::Apportion(FlatTree& t, Index v, Index leftSibingOfV, Index dac)
 {
     //
     //     [-]     [+]      o:  Outside contour.
@@ -153,59 +347,58 @@ Node* Layouter::Apportion(Node *v, Node *leftSibingOfV, Node *dac)
     //    o   i   i   o     RL: Right-tree Left-contour.
     //    LL  LR  RL  RR    RR: Right-tree Right-contour.
     //
-    if (leftSibingOfV)
+    if (leftSibingOfV != FlatTree::nil)
     {
         auto RL = v;
         auto RR = v;
         auto LR = leftSibingOfV;
-        auto LL = RL->parent()->leftMostChild(); // Left most sibling of RL.
+        auto LL = t.firstChild[t.parent[RL]]; // Left most sibling of RL.
 
-        auto LLMod = LL->mod();
-        auto LRMod = LR->mod();
-        auto RLMod = RL->mod();
-        auto RRMod = RR->mod();
+        auto LLMod = t.mod[LL];
+        auto LRMod = t.mod[LR];
+        auto RLMod = t.mod[RL];
+        auto RRMod = t.mod[RR];
 
         //
         // Compare Left tree(s) Right most contour and Right tree Left contour
         // at same level.
         //
-        while (NextRight(LR) && NextLeft(RL))
+        while (NextRight(t, LR) != FlatTree::nil && NextLeft(t, RL) != FlatTree::nil)
         {
-            LL = NextLeft(LL);
-            LR = NextRight(LR);
-            RL = NextLeft(RL);
-            RR = NextRight(RR);
-            RR->ancestor(v);
-
-            auto shift = (LR->prelim() + LRMod) 
-                       - (RL->prelim() + RLMod) 
-                       + nodeHSep_;
-                    // + Distance(LR);
+            LL = NextLeft(t, LL);
+            LR = NextRight(t, LR);
+            RL = NextLeft(t, RL);
+            RR = NextRight(t, RR);
+            SetState(t, &FlatTree::ancestor, RR, v);
+
+            auto shift = (t.prelim[LR] + LRMod) 
+                       - (t.prelim[RL] + RLMod) 
+                       + Distance(t, LR, RL);
             if (shift > 0.0f)
             {
-                MoveSubTree(Ancestor(LR, v, dac), v, shift);
+                MoveSubTree(t, Ancestor(t, LR, v, dac), v, shift);
                 RLMod += shift;
                 RRMod += shift;
             }
 
-            LLMod += LL->mod();
-            LRMod += LR->mod();
-            RLMod += RL->mod();
-            RRMod += RR->mod();
+            LLMod += t.mod[LL];
+            LRMod += t.mod[LR];
+            RLMod += t.mod[RL];
+            RRMod += t.mod[RR];
         } // while-end
 
-        if (NextRight(LR) != nullptr && NextRight(RR) == nullptr)
+        if (NextRight(t, LR) != FlatTree::nil && NextRight(t, RR) == FlatTree::nil)
         {
             // RR thread point to LR's right-contour at next level.
-            RR->thread(NextRight(LR));
-            RR->mod(RR->mod() + LRMod - RRMod);
+            SetState(t, &FlatTree::thread, RR, NextRight(t, LR));
+            SetState(t, &FlatTree::mod, RR, t.mod[RR] + LRMod - RRMod);
         }
 
-        if (NextLeft(RL) != nullptr && NextLeft(LL) == nullptr)
+        if (NextLeft(t, RL) != FlatTree::nil && NextLeft(t, LL) == FlatTree::nil)
         {
             // LL thread point to RL's left-contour at next level.
-            LL->thread(NextLeft(RL));
-            LL->mod(LL->mod() + RLMod - LLMod);
+            SetState(t, &FlatTree::thread, LL, NextLeft(t, RL));
+            SetState(t, &FlatTree::mod, LL, t.mod[LL] + RLMod - LLMod);
             dac = v;
         }
     } // if-leftSibingOfV-end
@@ -213,101 +406,70 @@ Node* Layouter::Apportion(Node *v, Node *leftSibingOfV, Node *dac)
     return dac;
 }
 
-Node* Layouter::NextLeft(Node *v)
+FlatTree::Index Layouter::NextLeft(const FlatTree& t, Index v)
 {
-    if (!v->childArray().empty())
+    if (t.firstChild[v] != FlatTree::nil)
     {
-        return v->leftMostChild();
+        return t.firstChild[v];
     }
     else
     {
-        return v->thread();
+        return t.thread[v];
     }
 }
 
-Node* Layouter::NextRight(Node *v)
+FlatTree::Index Layouter::NextRight(const FlatTree& t, Index v)
 {
-    if (!v->childArray().empty())
+    if (t.lastChild[v] != FlatTree::nil)
     {
-        return v->rightMostChild();
+        return t.lastChild[v];
     }
     else
     {
-        return v->thread();
+        return t.thread[v];
     }
 }
 
-void Layouter::MoveSubTree(Node *w0, Node *w1, double shift)
+void Layouter::MoveSubTree(FlatTree& t, Index w0, Index w1, double shift)
 {
-    //
-    // Count the number of subtrees from w0 to w1.
-    //
-    auto getNumber = [&]()
-    {
-        assert_true(w0 != nullptr);
-        assert_true(w0->parent() != nullptr);
-        assert_true(w1 != nullptr);
-        assert_true(w1->parent() == w0->parent());
-
-        auto end = w0->parent()->childArray().end();
-        auto left = end;
-        auto right = end;
-        for (auto it = w0->parent()->childArray().begin(); it != end; ++it)
-        {
-            if (*it == w0)
-            {
-                left = it;
-                for (it = it + 1; it != end; ++it)
-                {
-                    if (*it == w1)
-                    {
-                        right = it; // left < right.
-                        break;
-                    }
-                }
-                break;
-            }
-        }
-
-        assert_true(left != end);
-        assert_true(right != end);
-        // assert_true(left < right);
-
-        return right - left;
-    };
-
-    auto subtrees = getNumber();
-    w1->change(w1->change() - shift / subtrees);
-    w1->shift(w1->shift() + shift);
-    w0->change(w0->change() + shift / subtrees);
-    w1->prelim(w1->prelim() + shift);
-    w1->mod(w1->mod() + shift);
+    assert_true(w0 != FlatTree::nil);
+    assert_true(w1 != FlatTree::nil);
+    assert_true(t.parent[w0] != FlatTree::nil);
+    assert_true(t.parent[w1] == t.parent[w0]);
+    assert_true(t.number[w1] > t.number[w0]);
+
+    // The number of subtrees from w0 to w1, in O(1) for any fan-out.
+    double subtrees = t.number[w1] - t.number[w0];
+    SetState(t, &FlatTree::change, w1, t.change[w1] - shift / subtrees);
+    SetState(t, &FlatTree::shift, w1, t.shift[w1] + shift);
+    SetState(t, &FlatTree::change, w0, t.change[w0] + shift / subtrees);
+    SetState(t, &FlatTree::prelim, w1, t.prelim[w1] + shift);
+    SetState(t, &FlatTree::mod, w1, t.mod[w1] + shift);
 }
 
-void Layouter::ExecuteShifts(Node *v)
+void Layouter::ExecuteShifts(FlatTree& t, Index v)
 {
     double shift = {};
     double change = {};
 
-    auto & childArray = v->childArray();
-    for (auto it = childArray.rbegin(); it != childArray.rend(); ++it)
+    for (auto it = t.lastChild[v]; it != FlatTree::nil; it = t.prevSibling[it])
     {
-        (*it)->prelim((*it)->prelim() + shift);
-        (*it)->mod((*it)->mod() + shift);
-        change += (*it)->change();
-        shift += (*it)->shift() + change;
+        SetState(t, &FlatTree::prelim, it, t.prelim[it] + shift);
+        SetState(t, &FlatTree::mod, it, t.mod[it] + shift);
+        change += t.change[it];
+        shift += t.shift[it] + change;
     }
 }
 
-Node* Layouter::Ancestor(Node *vi, Node *v, Node *dac)
+FlatTree::Index Layouter::Ancestor(const FlatTree& t, Index vi, Index v, Index dac)
 {
-    assert_true(vi != nullptr);
-    assert_true(vi->ancestor() != nullptr);
-    assert_true(v != nullptr);
+    assert_true(vi != FlatTree::nil);
+    assert_true(t.ancestor[vi] != FlatTree::nil);
+    assert_true(v != FlatTree::nil);
 
-    if (vi->ancestor()->parent() == v->parent())
+    if (t.parent[t.ancestor[vi]] == t.parent[v])
     {
-        return vi->ancestor();
+        return t.ancestor[vi];
     }
     else
     {
@@ -315,10 +477,32 @@ Node* Layouter::Ancestor(Node *vi, Node *v, Node *dac)
     }
 }
 
-double Layouter::Distance(Node *v)
+double Layouter::Distance(const FlatTree& t, Index left, Index right)
+{
+    //
+    // The centers are nodeHSep apart, unless the labels are so wide that
+    // they would come closer than half a font size.
+    //
+    auto labelDistance = (t.width[left] + t.width[right]) * 0.5 + options_.fontSize * 0.5;
+    return (std::max)(options_.nodeHSep, labelDistance);
+}
+
+void Layouter::SetState(FlatTree& t, std::vector<double> FlatTree::* a, Index i, double value)
+{
+    auto& state = (t.*a)[i];
+    if(writes_ != nullptr && state != value)
+    {
+        writes_->emplace_back(a, i, state);
+    }
+    state = value;
+}
+
+void Layouter::SetState(FlatTree& t, std::vector<Index> FlatTree::* a, Index i, Index value)
 {
-    return nodeHSep_;
-    //return v->textBox().width;
-    //return v->textBox().width * 0.5 + 10.0f;
-    //return v->textBox().width + config::MinHSep;
-}
\ No newline at end of file
+    auto& state = (t.*a)[i];
+    if(writes_ != nullptr && state != value)
+    {
+        writes_->emplace_back(a, i, state);
+    }
+    state = value;
+}
@@ -10,14 +10,21 @@
 #pragma once
 
 #include "BaseType.h"
+#include "FlatTree.h"
 
 #include <memory>
+#include <vector>
 
 namespace cst
 {
     class Node;
     class Boxy;
     using BoxyPtr = std::shared_ptr<Boxy>;
+    class TextBoxCache;
+    using TextBoxCachePtr = std::shared_ptr<TextBoxCache>;
+    class GlyphMetrics;
+    using GlyphMetricsPtr = std::shared_ptr<GlyphMetrics>;
+    class ThreadPool;
 
     /**
      * @brief Calculate x and y position of a tree's all nodes.
@@ -28,27 +35,152 @@ namespace cst
         /**
          * @brief Construct a new Layouter object
          * 
-         * @param[in] fontSize  It determines the textbox of node label.
-         * @param[in] nodeHSep  Node horizontal separation.
-         * @param[in] nodeVSep  Node vertical separation.
+         * @param[in] options   The font size determines the textbox of node
+         *                      label, the node separations the layout.
+         * @param[in] cache     A textbox cache which may be shared with other
+         *                      layouters, a private one is made if nullptr.
+         * @param[in] metrics   Glyph metrics to measure text with, which may be
+         *                      shared with other layouters. If nullptr, each
+         *                      layouter measures by its own cairo context.
+         */
+        explicit Layouter(const RenderOptions& options = RenderOptions(),
+                          TextBoxCachePtr cache = nullptr,
+                          GlyphMetricsPtr metrics = nullptr);
+        /**
+         * @brief Measure labels on a thread pool.
+         * 
+         * A large tree is cut into ranges of nodes which are measured at the
+         * same time, each pool worker has its own Boxy. The textbox cache and
+         * glyph metrics are shared.
+         * 
+         * @param[in] pool      A pool which outlives the layouter, or nullptr
+         *                      to measure on the calling thread only.
+         */
+        void setThreadPool(ThreadPool* pool);
+        /**
+         * @brief Measure the labels of a flat tree made from nodes.
+         * 
+         * It is the pass before the layout, it sets the node textboxes and
+         * the flat tree widths.
+         * 
+         * @param[in,out] t         A tree made from nodes.
+         * @return true             Pass.
+         * @return false            Fail.
+         */
+        bool measure(FlatTree& t);
+        /**
+         * @brief Measure one label of a flat tree made from nodes again.
+         * 
+         * It sets the node textbox and the flat tree width after the label
+         * of node i was edited, before relayout(t, i, ...).
          * 
+         * @param[in,out] t         A tree made from nodes.
+         * @param[in] i             The node whose label changed.
+         * @return true             Pass.
+         * @return false            Fail, or the tree has no node i.
          */
-        Layouter(double fontSize = option::FontSize::getFontSize(),
-                 double nodeHSep = option::NodeSep::getHSep(),
-                 double nodeVSep = option::NodeSep::getVSep()
-        );
+        bool remeasure(FlatTree& t, FlatTree::Index i);
         /**
          * @brief Layout a tree using BJL's algorithm.
          * 
+         * The tree is copied to a FlatTree, its labels are measured by
+         * measure(), then it is laid out and the positions are copied back.
+         * 
          * @param[in] t             A tree to layout.
          * @param[out] TreeSize     The tree size.
          */
         bool layout(Node* t, TreeSize& treeSize);
 
+        /**
+         * @brief Layout a flat tree using BJL's algorithm.
+         * 
+         * @param[in,out] t         A tree to layout, its widths must be set.
+         * @param[out] TreeSize     The tree size.
+         */
+        bool layout(FlatTree& t, TreeSize& treeSize);
+
+        /**
+         * @brief Layout a flat tree again after a local edit.
+         * 
+         * The placement of every node is undone and walked again only on the
+         * path from the edit to the root, the subtrees beside that path keep
+         * their contours, prelim and mod from the last walk. The first call
+         * on a tree walks all of it and keeps the state for the next calls.
+         * 
+         * Only two edits are supported: a new width of one node, and nodes
+         * appended by FlatTree::add(). A subtree can not be removed,
+         * replaced or moved, such a tree is laid out again by layout().
+         * 
+         * The layouter keeps the undo state of the last tree given to
+         * relayout(), calling it with another tree starts that one over.
+         * 
+         * @param[in,out] t         A tree to layout, its widths must be set.
+         * @param[in] changed       The node whose width changed, or nil. Nodes
+         *                          appended by FlatTree::add() since the last
+         *                          call are laid out too.
+         * @param[out] TreeSize     The tree size.
+         */
+        bool relayout(FlatTree& t, FlatTree::Index changed, TreeSize& treeSize);
+
+        /**
+         * @brief Get the number of nodes whose layout state the last
+         *        relayout() undid or wrote.
+         * 
+         * @return std::size_t      The node count.
+         */
+        std::size_t touched()const;
+
     private:
+        using Index = FlatTree::Index;
+
+        const RenderOptions options_;
         BoxyPtr boxy_;
-        double nodeHSep_;
-        double nodeVSep_;
+        ThreadPool* pool_ = nullptr;
+        std::vector<BoxyPtr> workerBoxy_;   ///< Boxy of pool worker i, 0 is boxy_.
+
+        //
+        // A write to the layout algorithm state and the value it replaced.
+        //
+        struct Write
+        {
+            enum class Kind : std::uint8_t { Real, Link };
+
+            Write(std::vector<double> FlatTree::* a, Index i, double old)
+                : kind(Kind::Real), node(i)
+            {
+                array.real = a;
+                value.real = old;
+            }
+
+            Write(std::vector<Index> FlatTree::* a, Index i, Index old)
+                : kind(Kind::Link), node(i)
+            {
+                array.link = a;
+                value.link = old;
+            }
+
+            Kind kind;
+            Index node;
+            union
+            {
+                std::vector<double> FlatTree::* real;
+                std::vector<Index> FlatTree::* link;
+            } array;                ///< The array written, chosen by kind.
+            union
+            {
+                double real;
+                Index link;
+            } value;                ///< The replaced value, chosen by kind.
+        };
+
+        // Writes done while the children of node i of journalTree_ were
+        // placed, kept by relayout() to undo them. The generation tells a
+        // refilled tree at the same address from the journaled one.
+        std::vector<std::vector<Write>> journal_;
+        const FlatTree* journalTree_ = nullptr;
+        std::uint64_t journalGeneration_ = {};
+        std::vector<Write>* writes_ = nullptr;  ///< Where relayout() logs the writes.
+        std::size_t touched_ = {};
 
         //~~~~~~~~~~~~~~~~~~~Layout algorithm~~~~~~~~~~~~~~~~~~~~~~~~~
         // [Paper]
@@ -56,14 +188,19 @@ namespace cst
         // [Paper-Author]
         //   Christoph Buhheim, Michael Jünger, and Sebastian Leipert
         //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
-        void FirstWalk(Node *v, Boxy& boxy, Node *leftSibingOfV = nullptr);
-        void SecondWalk(Node *v, double m, size_t level = 0);
-        Node *Apportion(Node *v, Node *leftSibingOfV, Node *dac);
-        Node *NextLeft(Node *v);
-        Node *NextRight(Node *v);
-        void MoveSubTree(Node *w0, Node *w1, double shift);
-        void ExecuteShifts(Node *v);
-        Node *Ancestor(Node *vi, Node *v, Node *dac);
-        double Distance(Node *v);
+        // Both walks are loops over the node index, so deep trees do not
+        // overflow the call stack.
+        void FirstWalk(FlatTree& t);
+        void PlaceChildren(FlatTree& t, Index v);
+        void SecondWalk(FlatTree& t);
+        Index Apportion(FlatTree& t, Index v, Index leftSibingOfV, Index dac);
+        Index NextLeft(const FlatTree& t, Index v);
+        Index NextRight(const FlatTree& t, Index v);
+        void MoveSubTree(FlatTree& t, Index w0, Index w1, double shift);
+        void ExecuteShifts(FlatTree& t, Index v);
+        Index Ancestor(const FlatTree& t, Index vi, Index v, Index dac);
+        double Distance(const FlatTree& t, Index left, Index right);
+        void SetState(FlatTree& t, std::vector<double> FlatTree::* a, Index i, double value);
+        void SetState(FlatTree& t, std::vector<Index> FlatTree::* a, Index i, Index value);
     };
-} 
+}
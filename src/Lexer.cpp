@@ -9,16 +9,48 @@
 
 #include "Lexer.h"
 
+#include <cstring>
+#include <algorithm>
+
 using namespace cst;
 
-Lexer::Lexer(uint8_t* buf, std::size_t bufSize)
+Lexer::Lexer(const uint8_t* buf, std::size_t bufSize, CharScanner::Level level)
     :buf(buf),
     end(buf+bufSize),
-    cursor(buf),
     marker(buf),
+    cursor(buf),
     cppRawBegin(nullptr),
     cppRawEnd(nullptr),
-    currentTokenType(TokenType::Eof)
+    currentTokenType(TokenType::Eof),
+    scanner(level),
+    chunkSize(0),
+    consumed(0),
+    eof(true)
+{
+}
+
+Lexer::Lexer(Reader reader, std::size_t chunkSize)
+    :buf(nullptr),
+    end(nullptr),
+    marker(nullptr),
+    cursor(nullptr),
+    cppRawBegin(nullptr),
+    cppRawEnd(nullptr),
+    currentTokenType(TokenType::Eof),
+    reader(std::move(reader)),
+    chunkSize(chunkSize > 0 ? chunkSize : defChunkSize),
+    consumed(0),
+    eof(false)
+{
+}
+
+Lexer::Lexer(std::istream &is, std::size_t chunkSize)
+    :Lexer([&is](uint8_t *buf, std::size_t size) -> std::size_t
+            {
+                is.read((char*)buf, size);
+                return static_cast<std::size_t>(is.gcount());
+            },
+            chunkSize)
 {
 }
 
@@ -26,7 +58,7 @@ Lexer::TokenType Lexer::getNextTokenType()
 {
     marker = cursor;
 
-    while(cursor<end)
+    while(hasMore())
     {
         if(isLeftSquare(*cursor))
         {
@@ -42,20 +74,19 @@ Lexer::TokenType Lexer::getNextTokenType()
         }
         else if(isSpace(*cursor))
         {
-            ++cursor;
-            while(cursor<end && isSpace(*cursor))
+            cursor = scanner.skipSpace(cursor + 1, end);
+            marker = cursor;
+            while(cursor == end && refill())
             {
-                ++cursor;
+                cursor = scanner.skipSpace(cursor, end);
+                marker = cursor;
             }
-            marker = cursor;
             continue;
         }
         else if(isNonControlSpaceSquare(*cursor))
         {
-            auto backup = cursor;
-
             // Try to eat C++ raw string.
-            if(*cursor == 'R' && (cursor + 1) < end && *(cursor + 1) == '"')
+            if(*cursor == 'R' && hasMore(2) && *(cursor + 1) == '"')
             {
                 if(eatCppRawString())
                 {
@@ -70,11 +101,10 @@ Lexer::TokenType Lexer::getNextTokenType()
             }
             
             // Fall back to eat basic string.
-            cursor = backup;
-            ++cursor;
-            while(cursor<end && isNonControlSpaceSquare(*cursor))
+            cursor = scanner.skipLabel(marker + 1, end);
+            while(cursor == end && refill())
             {
-                ++cursor;
+                cursor = scanner.skipLabel(cursor, end);
             }
             currentTokenType = TokenType::BasicString;
             return currentTokenType;
@@ -96,20 +126,75 @@ Lexer::TokenType Lexer::getCurrentTokenType()
 }
 
 std::string Lexer::getCurrentToken()
+{
+    auto token = getCurrentTokenView();
+    return std::string(token.data(), token.size());
+}
+
+StrView Lexer::getCurrentTokenView()
 {
     if(currentTokenType == TokenType::CppRawString)
     {
-        return std::string((char*)cppRawBegin, cppRawEnd - cppRawBegin);
+        return StrView((const char*)cppRawBegin, cppRawEnd - cppRawBegin);
     }
     else
     {
-        return std::string((char*)marker, cursor - marker);
+        return StrView((const char*)marker, cursor - marker);
     }
 }
 
 std::size_t Lexer::getCursorOffset()
 {
-    return this->cursor - this->buf;
+    return this->consumed + (this->cursor - this->buf);
+}
+
+bool Lexer::hasMore(std::size_t n)
+{
+    while(static_cast<std::size_t>(end - cursor) < n)
+    {
+        if(!refill())
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool Lexer::refill()
+{
+    if(!reader || eof)
+    {
+        return false;
+    }
+
+    // Keep the current token only.
+    std::size_t keep = end - marker;
+    std::size_t cursorOffset = cursor - marker;
+    if(keep > 0 && marker != window.data())
+    {
+        std::memmove(window.data(), marker, keep);
+    }
+    consumed += marker - buf;
+
+    // Grow only when a single token is larger than the free space.
+    if(window.size() < keep + chunkSize)
+    {
+        window.resize((std::max)(window.size() * 2, keep + chunkSize));
+    }
+
+    buf = window.data();
+    marker = buf;
+    cursor = buf + cursorOffset;
+    end = buf + keep;
+
+    auto n = reader(window.data() + keep, window.size() - keep);
+    if(n == 0)
+    {
+        eof = true;
+        return false;
+    }
+    end += n;
+    return true;
 }
 
 bool Lexer::isLeftSquare(uint8_t ch)
@@ -124,48 +209,12 @@ bool Lexer::isRightSquare(uint8_t ch)
 
 bool Lexer::isNonControlSpaceSquare(uint8_t ch)
 {
-    static const bool nonControlSpaceSquare[256] = {
-        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
-        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
-        0, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
-        1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
-        1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
-        1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 1, 0, 1, 1,
-        1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
-        1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0,
-        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
-        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
-        1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
-        1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
-        1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
-        1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
-        1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
-        1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 0
-    };
-    return nonControlSpaceSquare[ch];
+    return CharScanner::isLabel(ch);
 }
 
 bool Lexer::isSpace(uint8_t ch)
 {
-    static const bool spaceCharArray[256] = {
-        0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 0, 1, 1, 0, 0,
-        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
-        1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
-        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
-        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
-        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
-        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
-        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
-        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
-        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
-        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
-        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
-        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
-        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
-        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
-        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0
-    };
-    return spaceCharArray[ch];
+    return CharScanner::isSpace(ch);
 }
 
 bool Lexer::eatCppRawString()
@@ -175,92 +224,62 @@ bool Lexer::eatCppRawString()
     //   ^           ^             ^           ^
     //   1           2             3           4
     //
-    uint8_t* prefixBegin = nullptr;     // 1
-    uint8_t* prefixEnd = nullptr;       // 2
-    uint8_t* suffixBegin = nullptr;     // 3
-    uint8_t* suffixEnd = nullptr;       // 4
-
-    auto isSamePrefixAndSuffix = [&]()
+    // The raw string ends at the first [)~~~~~~~~~~~~"] after [(], it is
+    // found by a single pass KMP matcher, so every byte is read once no
+    // matter how many ')' are in the raw string.
+    //
+    // Positions are offsets from marker, a streaming lexer may move the
+    // buffer while eating.
+    //
+    cursor += 2;    // Eat [R"]
+    while(hasMore() && *cursor != '(')
+    {
+        ++cursor;
+    }
+    if(!hasMore())
     {
-        if(prefixEnd-prefixBegin == suffixEnd - suffixBegin)
-        {
-            auto it1 = prefixBegin;
-            auto it2 = suffixBegin;
-            while(it1 < prefixEnd && *it1 == *it2 && *it1 == *prefixBegin)
-            {
-                ++it1;
-                ++it2;
-            }
-            if (it1 == prefixEnd && it2 == suffixEnd)
-            {
-                // Snapshot the raw string data.
-                cppRawBegin = prefixEnd + 1;
-                cppRawEnd = suffixBegin - 1;
-                return true;
-            }
-        }
-
         return false;
-    };
+    }
+    std::size_t prefixEnd = cursor++ - marker;  // 2
 
-    auto findPrefix = [&]()
-    {
-        cursor += 2;    // Eat [R"]
-        prefixBegin = cursor;
-        while(cursor < end && *cursor != '(')
-        {
-            ++cursor;
-        }
-        if(cursor < end && *cursor == '(')
-        {
-            prefixEnd = cursor++;
-            return true;
-        }
+    // Pattern [)~~~~~~~~~~~~"] and its failure function.
+    std::string pattern;
+    pattern.reserve(prefixEnd);
+    pattern += ')';
+    pattern.append((const char*)marker + 2, prefixEnd - 2);
+    pattern += '"';
 
-        return false;
-    };
+    std::vector<std::size_t> failure(pattern.size(), 0);
+    for(std::size_t i = 1, k = 0; i < pattern.size(); ++i)
+    {
+        while(k > 0 && pattern[i] != pattern[k]) k = failure[k - 1];
+        if(pattern[i] == pattern[k]) ++k;
+        failure[i] = k;
+    }
 
-    auto findSuffix = [&]()
+    std::size_t matched = 0;
+    while(true)
     {
-        while(cursor < end && *cursor != ')')
-        {
-            ++cursor;
-        }
-        if(cursor < end && *cursor == ')')
+        // Nothing is matched, jump to the next ')' or '"'.
+        if(matched == 0)
         {
-            suffixBegin = ++cursor;
+            cursor = scanner.findRawStop(cursor, end);
         }
-        else
+        if(!hasMore())
         {
             return false;
         }
 
-        while(cursor < end && *cursor != '"')
-        {
-            ++cursor;
-        }
-        if(cursor < end && *cursor == '"')
-        {
-            suffixEnd = cursor++;
-            return true;
-        }
-
-        return false;
-    };
+        auto ch = static_cast<char>(*cursor++);
+        while(matched > 0 && pattern[matched] != ch) matched = failure[matched - 1];
+        if(pattern[matched] == ch) ++matched;
 
-    //
-    // Working start here.
-    //
-    if(findPrefix())
-    {
-        while(cursor<end)
+        if(matched == pattern.size())
         {
-            if(findSuffix() && isSamePrefixAndSuffix())
-            {
-                return true;
-            }
+            // Snapshot the raw string data.
+            cppRawBegin = marker + prefixEnd + 1;   // 2 + 1
+            cppRawEnd = cursor - pattern.size();    // 3
+            return true;
         }
     }
-
-    return false;
 }
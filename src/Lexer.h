@@ -9,7 +9,14 @@
 
 #pragma once
 
+#include "CharScanner.h"
+#include "BaseType.h"
+
+#include <cstdint>
 #include <string>
+#include <vector>
+#include <istream>
+#include <functional>
 
 namespace cst
 {
@@ -32,13 +39,45 @@ namespace cst
             CppRawString    ///< Node label of C++ raw string like R"(...)"
         };
 
+        /**
+         * @brief Pull more input for a streaming lexer.
+         * 
+         * It copies at most size bytes to buf and returns the copied count,
+         * zero means end of stream.
+         */
+        using Reader = std::function<std::size_t(uint8_t *buf, std::size_t size)>;
+
+        static constexpr std::size_t defChunkSize = 64 * 1024; ///< Default streaming chunk size.
+
         /**
          * @brief Init a lexer with a stream buffer.
          * 
          * @param buf       ///< Buffer begin.
          * @param bufSize   ///< Buffer size.
+         * @param level     ///< Character scanning instruction set.
+         */
+        Lexer(const uint8_t *buf, 
+              std::size_t bufSize, 
+              CharScanner::Level level = CharScanner::bestLevel());
+
+        /**
+         * @brief Init a streaming lexer which pulls input chunk by chunk.
+         * 
+         * Only the current token is kept in memory, so the memory usage is
+         * bounded by the chunk size and the longest token, not by the input size.
+         * 
+         * @param reader    ///< Input reader.
+         * @param chunkSize ///< Bytes to pull at a time.
+         */
+        Lexer(Reader reader, std::size_t chunkSize = defChunkSize);
+
+        /**
+         * @brief Init a streaming lexer which pulls input from a std::istream.
+         * 
+         * @param is        ///< Input stream, it must outlive the lexer.
+         * @param chunkSize ///< Bytes to pull at a time.
          */
-        Lexer(uint8_t *buf, std::size_t bufSize);
+        Lexer(std::istream &is, std::size_t chunkSize = defChunkSize);
 
         /**
          * @brief Parse the stream and return next token type.
@@ -61,6 +100,16 @@ namespace cst
          */
         std::string getCurrentToken();
 
+        /**
+         * @brief Get the Current Token without copying it.
+         * 
+         * The view points into the lexer buffer and it is valid until the
+         * next getNextTokenType call.
+         * 
+         * @return StrView      Current token.
+         */
+        StrView getCurrentTokenView();
+
         /**
          * @brief Get the cursor offset from stream begin.
          * 
@@ -71,15 +120,44 @@ namespace cst
         std::size_t getCursorOffset();
 
     private:
-        uint8_t *buf;    ///< Buffer iterator Begin.
-        uint8_t *end;    ///< Buffer iterator end.
-        uint8_t *marker; ///< Current token begin.
-        uint8_t *cursor; ///< Next Token begin.
+        const uint8_t *buf;    ///< Buffer iterator Begin.
+        const uint8_t *end;    ///< Buffer iterator end.
+        const uint8_t *marker; ///< Current token begin.
+        const uint8_t *cursor; ///< Next Token begin.
 
-        uint8_t *cppRawBegin; ///< Current cpp raw string begin.
-        uint8_t *cppRawEnd;   ///< Current cpp raw string end.
+        const uint8_t *cppRawBegin; ///< Current cpp raw string begin.
+        const uint8_t *cppRawEnd;   ///< Current cpp raw string end.
 
         TokenType currentTokenType; ///< Current token type.
+        CharScanner scanner;        ///< Skip character runs.
+
+        Reader reader;                  ///< Streaming input, empty for a plain buffer.
+        std::vector<uint8_t> window;    ///< Streaming buffer, holds the current token.
+        std::size_t chunkSize;          ///< Streaming chunk size.
+        std::size_t consumed;           ///< Bytes dropped before buf.
+        bool eof;                       ///< Streaming input is exhausted.
+
+        /**
+         * @brief Make sure there are at least n bytes from cursor.
+         * 
+         * A streaming lexer refills its buffer when needed.
+         * 
+         * @param n         Bytes needed.
+         * @return true     The bytes are available.
+         * @return false    End of stream.
+         */
+        inline bool hasMore(std::size_t n = 1);
+
+        /**
+         * @brief Drop the bytes before the current token and pull another chunk.
+         * 
+         * It moves marker, cursor and end, and pointers into the old buffer
+         * are invalid after it.
+         * 
+         * @return true     Some bytes are pulled.
+         * @return false    End of stream.
+         */
+        bool refill();
 
         /**
          * @brief Checks whether ch is a '[' character.
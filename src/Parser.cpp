@@ -28,107 +28,149 @@ using TokenType = Lexer::TokenType;
 //                              |                      |
 //                              +------>( Label )------+
 //
-Node *buildSubStree(Lexer &lexer, Node *parent)
+// A "[" inside a node opens a child node, it is pushed to the stack of open
+// nodes instead of recursing, and the matching "]" pops it.
+//
+Node *buildSubStree(Lexer &lexer, SyntaxTree &tree, std::size_t maxDepth)
 {
-    Node *pNode;
+    NodeArray stack;
+    Node *treeRoot = nullptr;
     auto tokenType = lexer.getCurrentTokenType();
 
-    auto collectProperty = [](Node *pNode, const TokenType& tokenType, const std::string& text)
+    //
+    // The token is copied once into the tree arena, as the label of a basic
+    // string node or as the raw string of a C++ raw string node.
+    //
+    auto newNode = [&tree](const TokenType& tokenType, StrView token)
     {
         if(tokenType == TokenType::CppRawString)
         {
-            auto prop = PropertyParser::toProperty(text);
-            auto labelFromProp = prop["label"];
+            auto pNode = tree.newNode(StrView());
+            pNode->cppRawStr(token);
+
+            // A property without a label gets an empty one.
+            auto prop = PropertyParser::toProperty(std::string(token.data(), token.size()));
+            auto &labelFromProp = prop["label"];
             if(!labelFromProp.empty())
             {
                 pNode->label(labelFromProp);
             }
-            else
-            {
-                pNode->label(option::defEmptyLabel);
-            }
-            pNode->cppRawStr(text);
-            pNode->property(prop);
+            pNode->property(std::move(prop));
+            return pNode;
         }
-        return pNode;
+        return tree.newNode(token);
+    };
+
+    // The partial tree is released with the tree arena.
+    auto fail = [&](const std::string& reason)
+    {
+        std::string msg;
+        msg += "Parser::buildSubStree failed.\n";
+        msg += reason;
+        msg += "lexer::cursor offset = ";
+        msg += std::to_string(lexer.getCursorOffset()) + ".\n";
+        throw std::runtime_error(msg.c_str());
     };
 
     // Begin.
-    if (tokenType == TokenType::LeftSquare)
+    while (tokenType == TokenType::LeftSquare)
     {
         tokenType = lexer.getNextTokenType();
-        if (tokenType == TokenType::CppRawString || tokenType == TokenType::BasicString)
+        if (tokenType != TokenType::CppRawString && tokenType != TokenType::BasicString)
+        {
+            break;
+        }
+
+        if (stack.size() >= maxDepth)
         {
-            // Current node label
-            pNode = SyntaxTree::newNode(lexer.getCurrentToken());
-            collectProperty(pNode, tokenType, lexer.getCurrentToken());
+            fail("The tree is deeper than " + std::to_string(maxDepth) + ".\n");
+        }
 
-            // Zero or more child list.
-            while (true)
+        // Current node label
+        auto pNode = newNode(tokenType, lexer.getCurrentTokenView());
+        if (stack.empty())
+        {
+            treeRoot = pNode;
+        }
+        else
+        {
+            stack.back()->append(pNode);
+        }
+        stack.push_back(pNode);
+
+        // Zero or more child list.
+        while (true)
+        {
+            tokenType = lexer.getNextTokenType();
+            if (tokenType == TokenType::BasicString || tokenType == TokenType::CppRawString)
             {
-                tokenType = lexer.getNextTokenType();
-                if (tokenType == TokenType::BasicString || tokenType == TokenType::CppRawString)
-                {
-                    // One child label.
-                    auto child = SyntaxTree::newNode(lexer.getCurrentToken());
-                    collectProperty(child, tokenType, lexer.getCurrentToken());
-                    pNode->append(child);
-                }
-                else if (tokenType == TokenType::LeftSquare)
-                {
-                    // One child node.
-                    pNode->append(buildSubStree(lexer, pNode));
-                }
-                else if (tokenType == TokenType::RightSquare)
-                {
-                    // Fininshed.
-                    return pNode;
-                }
-                else
+                // One child label.
+                stack.back()->append(newNode(tokenType, lexer.getCurrentTokenView()));
+            }
+            else if (tokenType == TokenType::LeftSquare)
+            {
+                // One child node.
+                break;
+            }
+            else if (tokenType == TokenType::RightSquare)
+            {
+                // Fininshed.
+                stack.pop_back();
+                if (stack.empty())
                 {
-                    // Any error.
-                    break;
+                    return treeRoot;
                 }
             }
+            else
+            {
+                // Any error.
+                break;
+            }
         }
     }
 
+    fail("");
+
+    return {};
+}
+
+// The current token must be the "[" of the tree.
+SyntaxTreePtr buildTree(Lexer &lexer, std::size_t maxDepth)
+{
+    auto syntaxTree = std::make_shared<SyntaxTree>();
+    auto treeRoot = buildSubStree(lexer, *syntaxTree, maxDepth);
+    syntaxTree->setRoot(treeRoot);
+    return syntaxTree;
+}
+
+// The input is not exactly one tree.
+[[noreturn]] void throwSyntaxTreeError(Lexer &lexer)
+{
     std::string msg;
-    msg += "Parser::buildSubStree failed.\n";
+    msg += "Parser::buildSyntaxTree failed.\n";
     msg += "lexer::cursor offset = ";
     msg += std::to_string(lexer.getCursorOffset()) + ".\n";
     throw std::runtime_error(msg.c_str());
-
-    return {};
 }
 
-SyntaxTreePtr Parser::buildSyntaxTree(const std::string &stream)
+SyntaxTreePtr buildSyntaxTree(Lexer &lexer, std::size_t maxDepth)
 {
-    if (stream.empty())
-        return {};
-
     try
     {
-        Lexer lexer((uint8_t *)stream.data(), stream.size());
+        // An empty input has no tree and no error, as in TreeReader::next.
+        // Input of only white space is a parse error.
+        if (lexer.getNextTokenType() == Lexer::TokenType::Eof && lexer.getCursorOffset() == 0)
+            return {};
 
-        lexer.getNextTokenType();
-        auto rootNodeLabel = lexer.getCurrentToken();
-
-        auto treeRoot = buildSubStree(lexer, nullptr);
+        auto syntaxTree = buildTree(lexer, maxDepth);
 
         if (lexer.getNextTokenType() == Lexer::TokenType::Eof)
         {
-            auto syntaxTree = std::make_shared<SyntaxTree>();
-            syntaxTree->setRoot(treeRoot);
             return syntaxTree;
         }
         else
         {
-            std::string msg;
-            msg += "Parser::buildSyntaxTree failed.\n";
-            msg += "lexer::cursor offset = ";
-            msg += std::to_string(lexer.getCursorOffset()) + ".\n";
-            throw std::runtime_error(msg.c_str());
+            throwSyntaxTreeError(lexer);
         }
     }
     catch (const std::exception &e)
@@ -138,3 +180,85 @@ SyntaxTreePtr Parser::buildSyntaxTree(const std::string &stream)
 
     return {};
 }
+
+SyntaxTreePtr Parser::buildSyntaxTree(const std::string &stream, std::size_t maxDepth)
+{
+    return buildSyntaxTree((const uint8_t *)stream.data(), stream.size(), maxDepth);
+}
+
+SyntaxTreePtr Parser::buildSyntaxTree(const uint8_t *data, std::size_t size, std::size_t maxDepth)
+{
+    if (data == nullptr || size == 0)
+        return {};
+
+    Lexer lexer(data, size);
+    return ::buildSyntaxTree(lexer, maxDepth);
+}
+
+SyntaxTreePtr Parser::buildSyntaxTree(std::istream &stream, std::size_t maxDepth)
+{
+    Lexer lexer(stream);
+    return ::buildSyntaxTree(lexer, maxDepth);
+}
+
+TreeReader::iterator::iterator(TreeReader *reader)
+    : reader_(reader)
+{
+    if (reader_)
+        tree_ = reader_->next();
+}
+
+TreeReader::iterator &TreeReader::iterator::operator++()
+{
+    tree_ = reader_->next();
+    return *this;
+}
+
+TreeReader::TreeReader(const uint8_t *data, std::size_t size, std::size_t maxDepth)
+    : maxDepth_(maxDepth)
+{
+    if (data == nullptr || size == 0)
+        done_ = true;
+    else
+        lexer_.reset(new Lexer(data, size));
+}
+
+TreeReader::TreeReader(std::istream &stream, std::size_t maxDepth)
+    : lexer_(new Lexer(stream)), maxDepth_(maxDepth)
+{
+}
+
+TreeReader::~TreeReader() = default;
+
+SyntaxTreePtr TreeReader::next()
+{
+    if (done_ || !good_)
+        return {};
+
+    try
+    {
+        if (lexer_->getNextTokenType() == Lexer::TokenType::Eof)
+        {
+            // Input of only white space has no tree, it is an error as in
+            // Parser::buildSyntaxTree, so a blank file is not taken for an
+            // empty corpus. An empty input has no error.
+            if (count_ == 0 && lexer_->getCursorOffset() > 0)
+                throwSyntaxTreeError(*lexer_);
+
+            done_ = true;
+            return {};
+        }
+
+        auto syntaxTree = buildTree(*lexer_, maxDepth_);
+        ++count_;
+        return syntaxTree;
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "TreeReader::next failed at tree " << count_ + 1 << ".\n";
+        std::cerr << e.what() << '\n';
+    }
+
+    good_ = false;
+    return {};
+}
@@ -9,16 +9,25 @@
 
 #pragma once
 
+#include "BaseType.h"
+
+#include <cstdint>
 #include <string>
 #include <memory>
+#include <istream>
+#include <iterator>
 
 namespace cst
 {
     class SyntaxTree;
     using SyntaxTreePtr = std::shared_ptr<SyntaxTree>;
+    class Lexer;
 
     /**
      * @brief Parse stream and return a syntax tree.
+     * 
+     * The parser keeps open nodes on an explicit stack, so the tree depth
+     * is only limited by maxDepth, not by the call stack.
      */
     class Parser
     {
@@ -27,9 +36,135 @@ namespace cst
          * @brief Parse stream and return a syntax tree.
          * 
          * @param[in] stream        Stream to be parsed.
+         * @param[in] maxDepth      Max tree depth, a deeper tree is an error.
+         * 
+         * @return SyntaxTreePtr    A syntax tree.
+         */
+        static SyntaxTreePtr buildSyntaxTree(const std::string &stream,
+                                             std::size_t maxDepth = option::TreeDepth::defValue);
+
+        /**
+         * @brief Parse stream and return a syntax tree.
+         * 
+         * The buffer is scanned in place, so it can be a memory-mapped file.
+         * 
+         * @param[in] data          Stream begin.
+         * @param[in] size          Stream size.
+         * @param[in] maxDepth      Max tree depth, a deeper tree is an error.
+         * 
+         * @return SyntaxTreePtr    A syntax tree.
+         */
+        static SyntaxTreePtr buildSyntaxTree(const uint8_t *data, 
+                                             std::size_t size,
+                                             std::size_t maxDepth = option::TreeDepth::defValue);
+
+        /**
+         * @brief Parse stream and return a syntax tree.
+         * 
+         * The stream is pulled chunk by chunk, so it can be a pipe.
+         * 
+         * @param[in] stream        Stream to be parsed.
+         * @param[in] maxDepth      Max tree depth, a deeper tree is an error.
          * 
          * @return SyntaxTreePtr    A syntax tree.
          */
-        static SyntaxTreePtr buildSyntaxTree(const std::string &stream);
+        static SyntaxTreePtr buildSyntaxTree(std::istream &stream,
+                                             std::size_t maxDepth = option::TreeDepth::defValue);
+    };
+
+    /**
+     * @brief Parse a stream of top-level trees one by one.
+     * 
+     * A corpus file may hold many trees one after another, like "[a][b [c]]".
+     * Each call of next() parses just one more tree, so only the trees still
+     * referenced by the caller are kept in memory.
+     * 
+     * Usage:
+     *     TreeReader reader(data, size);
+     *     for (auto& tree : reader) { ... }
+     *     if (!reader.good()) { ... }
+     */
+    class TreeReader
+    {
+    public:
+        /**
+         * @brief Input iterator over the trees, it pulls the next tree when incremented.
+         */
+        class iterator
+        {
+        public:
+            using iterator_category = std::input_iterator_tag;
+            using value_type = SyntaxTreePtr;
+            using difference_type = std::ptrdiff_t;
+            using pointer = const SyntaxTreePtr *;
+            using reference = const SyntaxTreePtr &;
+
+            iterator(TreeReader *reader = nullptr);
+            reference operator*() const { return tree_; }
+            pointer operator->() const { return &tree_; }
+            iterator &operator++();
+            bool operator==(const iterator &other) const { return tree_ == other.tree_; }
+            bool operator!=(const iterator &other) const { return tree_ != other.tree_; }
+
+        private:
+            TreeReader *reader_;
+            SyntaxTreePtr tree_;
+        };
+
+        /**
+         * @brief Read trees from a buffer, it must outlive the reader.
+         * 
+         * @param[in] data          Stream begin.
+         * @param[in] size          Stream size.
+         * @param[in] maxDepth      Max tree depth, a deeper tree is an error.
+         */
+        TreeReader(const uint8_t *data, 
+                   std::size_t size, 
+                   std::size_t maxDepth = option::TreeDepth::defValue);
+
+        /**
+         * @brief Read trees from a stream, it must outlive the reader.
+         * 
+         * @param[in] stream        Stream to be parsed.
+         * @param[in] maxDepth      Max tree depth, a deeper tree is an error.
+         */
+        TreeReader(std::istream &stream,
+                   std::size_t maxDepth = option::TreeDepth::defValue);
+
+        ~TreeReader();
+
+        TreeReader(const TreeReader &) = delete;
+        TreeReader &operator=(const TreeReader &) = delete;
+
+        /**
+         * @brief Parse the next tree.
+         * 
+         * @return SyntaxTreePtr    The next tree, or nullptr at the end of
+         *                          stream or on error.
+         */
+        SyntaxTreePtr next();
+
+        /**
+         * @brief Check no parse error happened.
+         * 
+         * @return true     Ok, a nullptr from next() means end of stream.
+         * @return false    A tree failed to parse, no more trees are read.
+         */
+        bool good() const { return good_; }
+
+        /**
+         * @brief Get the number of trees parsed so far.
+         */
+        std::size_t count() const { return count_; }
+
+        iterator begin() { return iterator(this); }
+        iterator end() { return iterator(); }
+
+    private:
+        std::unique_ptr<Lexer> lexer_;
+        std::size_t maxDepth_;
+        std::size_t count_ = 0;
+        bool good_ = true;
+        bool done_ = false;
     };
 }//namespace cst
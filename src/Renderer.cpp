@@ -9,41 +9,85 @@
 
 #include "Renderer.h"
 #include "CairoContext.h"
+#include "GlyphRunCache.h"
+#include "SpatialIndex.h"
 #include "config.h"
 
+#include <algorithm>
 #include <cassert>
+#include <cmath>
 
 using namespace cst;
 
+constexpr std::size_t Renderer::edgeBatch;
+
 Renderer::Renderer(SyntaxTreePtr pSyntaxTree, 
                     TreeSize treeSize,
                     std::string fileName,
-                    std::string fileType, 
-                    double fontSize,
-                    double pageMarginW,
-                    double pageMarginH)
+                    const RenderOptions& options)
+    :tree_(pSyntaxTree),
+    treeSize_(treeSize),
+    options_(options),
+    fileName_(fileName)
+{
+}
+
+Renderer::Renderer(SyntaxTreePtr pSyntaxTree, 
+                    TreeSize treeSize,
+                    CairoContextPtr ctx,
+                    const RenderOptions& options)
     :tree_(pSyntaxTree),
     treeSize_(treeSize),
-    fileType_(fileType),
-    fileName_(fileName),
-    fontSize_(fontSize),
-    pageMarginW_(pageMarginW),
-    pageMarginH_(pageMarginH)
+    ctx_(ctx),
+    options_(options),
+    sharedContext_(true)
+{
+}
+
+CairoContextPtr Renderer::createBook(const std::string &fileName, const RenderOptions& options)
 {
+    // Every page is resized to its tree before drawing.
+    static constexpr double firstPageSize = 100.0;
+
+    RenderOptions pdfOptions = options;
+    pdfOptions.fileType = "pdf";
+    auto ctx = std::make_shared<CairoContext>(firstPageSize, firstPageSize, fileName, pdfOptions);
+    return ctx->good() ? ctx : nullptr;
 }
 
 bool Renderer::drawTree()
 {
     assert(tree_ != nullptr);
 
+    stats_ = DrawStats();
     auto page = getPage();
 
-    ctx_ = std::make_shared<CairoContext>(page.width,
-                                           page.height,
-                                           fileType_,
-                                           fileName_,
-                                           fontSize_);
-    if(!ctx_->good()) return false;
+    if (!sharedContext_ && options_.fileType == "png")
+    {
+        auto tileSize = options_.tileSize;
+        if (tileSize == 0 && (page.width > option::TileSize::valueMax || page.height > option::TileSize::valueMax))
+        {
+            tileSize = option::TileSize::autoValue;
+        }
+        if (tileSize > 0)
+        {
+            return drawTiles(page, tileSize);
+        }
+    }
+
+    if (sharedContext_)
+    {
+        // A shared context, the tree is a new page of it.
+        if (!ctx_ || !ctx_->setPageSize(page.width, page.height)) return false;
+    }
+    else
+    {
+        ctx_ = std::make_shared<CairoContext>(page.width,
+                                               page.height,
+                                               fileName_,
+                                               options_);
+        if(!ctx_->good()) return false;
+    }
 
     internalDrawTree();
     saveFile();
@@ -51,10 +95,155 @@ bool Renderer::drawTree()
     return true;
 }
 
+std::size_t Renderer::tileCount()const
+{
+    return tileCount_;
+}
+
+const DrawStats &Renderer::drawStats()const
+{
+    return stats_;
+}
+
+GlyphRunCachePtr Renderer::createGlyphRunCache()
+{
+    return std::make_shared<GlyphRunCache>();
+}
+
+void Renderer::setGlyphRunCache(GlyphRunCachePtr glyphRuns)
+{
+    glyphRuns_ = glyphRuns;
+}
+
+std::string Renderer::tileFileName(const std::string &fileName, std::size_t row, std::size_t col)
+{
+    auto tile = ".r" + std::to_string(row) + ".c" + std::to_string(col);
+    auto dot = fileName.find_last_of('.');
+    auto slash = fileName.find_last_of("/\\");
+    if (dot == std::string::npos || (slash != std::string::npos && dot < slash))
+        return fileName + tile;
+    return fileName.substr(0, dot) + tile + fileName.substr(dot);
+}
+
 void Renderer::internalDrawTree()
 {
     fillPage();
-    drawNode(tree_->getRoot());
+
+    auto scaled = options_.scale != 1.0;
+    if (scaled)
+    {
+        cairo_save(ctx_->cr());
+        cairo_scale(ctx_->cr(), options_.scale, options_.scale);
+    }
+
+    if (options_.lodSize > 0.0)
+    {
+        drawLod(tree_->getRoot());
+    }
+    else
+    {
+        drawNode(tree_->getRoot());
+    }
+
+    if (scaled)
+    {
+        cairo_restore(ctx_->cr());
+    }
+}
+
+bool Renderer::drawTiles(const Box& page, std::size_t tileSize)
+{
+    if (fileName_.empty())
+    {
+        return false;
+    }
+
+    // A node is drawn with the edge to its parent, it is indexed by the
+    // bounds of both. Ids are the preorder positions, the drawing order.
+    // The index is in page units, the tiles are in pixels.
+    auto pixel = 1.0 / options_.scale;
+    NodeArray nodes;
+    std::vector<SpatialIndex::Item> items;
+    NodeArray stack{tree_->getRoot()};
+    while (!stack.empty())
+    {
+        auto n = stack.back();
+        stack.pop_back();
+
+        // One pixel more for the line width and antialiasing.
+        SpatialIndex::Item item;
+        item.id = static_cast<SpatialIndex::Id>(nodes.size());
+        item.rect.x0 = cx(n) - n->textBox().width * 0.5 - pixel;
+        item.rect.x1 = cx(n) + n->textBox().width * 0.5 + pixel;
+        item.rect.y0 = cy(n) - n->textBox().height * 0.5 - pixel;
+        item.rect.y1 = cy(n) + n->textBox().height * 0.5 + pixel;
+        if (n->parent() != nullptr)
+        {
+            auto px = cx(n->parent());
+            item.rect.x0 = (std::min)(item.rect.x0, px - pixel);
+            item.rect.x1 = (std::max)(item.rect.x1, px + pixel);
+            item.rect.y0 = (std::min)(item.rect.y0, cy(n->parent()) - pixel);
+        }
+        items.push_back(item);
+        nodes.push_back(n);
+
+        auto &childArray = n->childArray();
+        for (auto it = childArray.rbegin(); it != childArray.rend(); ++it)
+        {
+            stack.push_back(*it);
+        }
+    }
+
+    SpatialIndex index;
+    index.build(std::move(items));
+
+    auto width = static_cast<std::size_t>(std::ceil(page.width));
+    auto height = static_cast<std::size_t>(std::ceil(page.height));
+    auto rows = (height + tileSize - 1) / tileSize;
+    auto cols = (width + tileSize - 1) / tileSize;
+    tileCount_ = rows * cols;
+
+    for (std::size_t row = 0; row < rows; ++row)
+    {
+        for (std::size_t col = 0; col < cols; ++col)
+        {
+            // Edge tiles are cut to the page, but not below cairo's minimum.
+            SpatialIndex::Rect tile;
+            tile.x0 = static_cast<double>(col * tileSize);
+            tile.y0 = static_cast<double>(row * tileSize);
+            tile.x1 = (std::max)(tile.x0 + 2.0, static_cast<double>((std::min)(width, (col + 1) * tileSize)));
+            tile.y1 = (std::max)(tile.y0 + 2.0, static_cast<double>((std::min)(height, (row + 1) * tileSize)));
+
+            ctx_ = std::make_shared<CairoContext>(tile.x1 - tile.x0, tile.y1 - tile.y0, fileName_, options_);
+            if (!ctx_->good())
+            {
+                return false;
+            }
+
+            cairo_translate(ctx_->cr(), -tile.x0, -tile.y0);
+            cairo_scale(ctx_->cr(), options_.scale, options_.scale);
+
+            SpatialIndex::Rect area;
+            area.x0 = tile.x0 * pixel;
+            area.y0 = tile.y0 * pixel;
+            area.x1 = tile.x1 * pixel;
+            area.y1 = tile.y1 * pixel;
+            NodeArray tileNodes;
+            for (auto id : index.query(area))
+            {
+                tileNodes.push_back(nodes[id]);
+            }
+            drawNodes(tileNodes);
+
+            if (cairo_surface_write_to_png(ctx_->cs(), tileFileName(fileName_, row, col).c_str()) != CAIRO_STATUS_SUCCESS)
+            {
+                return false;
+            }
+            ctx_.reset();
+        }
+    }
+
+    return true;
 }
 
 void Renderer::fillPage()
@@ -62,36 +251,191 @@ void Renderer::fillPage()
     // To be done.
 }
 
-void Renderer::drawNode(Node *n)
+void Renderer::drawNode(Node *t)
 {
-    drawEdge(n);
-    drawBox(n);
-    drawText(n);
+    // Preorder, children are pushed in reverse to keep the drawing order.
+    NodeArray nodes;
+    NodeArray stack;
+    stack.push_back(t);
 
-    for (auto child : n->childArray())
+    while (!stack.empty())
     {
-        drawNode(child);
+        auto n = stack.back();
+        stack.pop_back();
+        nodes.push_back(n);
+
+        auto &childArray = n->childArray();
+        for (auto it = childArray.rbegin(); it != childArray.rend(); ++it)
+        {
+            stack.push_back(*it);
+        }
     }
+
+    drawNodes(nodes);
 }
 
-void Renderer::drawEdge(Node *n)
+void Renderer::drawNodes(const NodeArray &nodes)
 {
-    // Edge is from this node to parent node.
-    if (n->parent() == nullptr)
+    drawEdges(nodes);
+    for (auto n : nodes)
+    {
+        drawBox(n);
+    }
+    drawTexts(nodes);
+}
+
+void Renderer::drawLod(Node *t)
+{
+    // Sizes in page units of one output pixel and of the smallest label
+    // drawn as text.
+    auto pixel = 1.0 / options_.scale;
+    auto minTextHeight = options_.lodSize * pixel;
+
+    // The nodes in preorder, subtree i is [i, i + count[i]).
+    struct Extent
+    {
+        std::size_t parent;
+        std::size_t count;
+        double left;
+        double right;
+        double bottom;
+    };
+    NodeArray order;
+    std::vector<Extent> extents;
+    std::vector<std::pair<Node*, std::size_t>> stack{{t, 0}};
+    while (!stack.empty())
+    {
+        auto n = stack.back().first;
+        auto parent = stack.back().second;
+        stack.pop_back();
+
+        auto &box = n->textBox();
+        extents.push_back({parent, 1, 
+                           cx(n) - box.width * 0.5, 
+                           cx(n) + box.width * 0.5, 
+                           cy(n) + box.height * 0.5});
+        auto self = order.size();
+        order.push_back(n);
+
+        auto &childArray = n->childArray();
+        for (auto it = childArray.rbegin(); it != childArray.rend(); ++it)
+        {
+            stack.emplace_back(*it, self);
+        }
+    }
+
+    for (auto i = order.size(); i-- > 1;)
     {
-        return;
+        auto &child = extents[i];
+        auto &parent = extents[child.parent];
+        parent.count += child.count;
+        parent.left = (std::min)(parent.left, child.left);
+        parent.right = (std::max)(parent.right, child.right);
+        parent.bottom = (std::max)(parent.bottom, child.bottom);
     }
-    cairo_move_to(ctx_->cr(), 
-                    cx(n), 
-                    cy(n) - fontSize_ * 0.45
-                    );
-    cairo_line_to(ctx_->cr(), 
-                    cx(n->parent()), 
-                    cy(n->parent()) + fontSize_ * 0.45
-                    );
 
+    // Edges go to one path. Siblings are visited left to right, an edge
+    // which lands in the pixel of the last drawn edge of the same parent
+    // is dropped.
+    std::vector<double> lastEdge(order.size(), 0.0);
+    std::vector<bool> hasEdge(order.size(), false);
+    auto collapsed = [&](std::size_t i) {
+        return extents[i].count > 1 && extents[i].right - extents[i].left < pixel;
+    };
+    cairo_new_path(ctx_->cr());
+    for (std::size_t i = 0; i < order.size();)
+    {
+        auto n = order[i];
+        auto parent = extents[i].parent;
+        if (i > 0 && (!hasEdge[parent] || cx(n) - lastEdge[parent] >= pixel))
+        {
+            hasEdge[parent] = true;
+            lastEdge[parent] = cx(n);
+            ++stats_.edges;
+            cairo_move_to(ctx_->cr(), cx(n), cy(n) - options_.fontSize * 0.45);
+            cairo_line_to(ctx_->cr(), cx(n->parent()), cy(n->parent()) + options_.fontSize * 0.45);
+        }
+        i += collapsed(i) ? extents[i].count : 1;
+    }
+    // Not thinner than half a pixel, or a thumbnail loses its edges.
+    cairo_set_line_width(ctx_->cr(), (std::max)(0.5, 0.5 * pixel));
     cairo_set_source_rgba(ctx_->cr(), 0.0, 0.0, 0.0, 0.85);
     cairo_stroke(ctx_->cr());
+    cairo_set_line_width(ctx_->cr(), 0.5);
+    ++stats_.strokes;
+
+    // Small labels and thin subtrees go to one filled path, a collapsed
+    // subtree is a triangle from its top to its bottom.
+    NodeArray texts;
+    for (std::size_t i = 0; i < order.size();)
+    {
+        auto n = order[i];
+        auto &e = extents[i];
+        if (collapsed(i))
+        {
+            cairo_move_to(ctx_->cr(), cx(n), cy(n) - options_.fontSize * 0.45);
+            cairo_line_to(ctx_->cr(), e.right, e.bottom);
+            cairo_line_to(ctx_->cr(), e.left, e.bottom);
+            cairo_close_path(ctx_->cr());
+            ++stats_.triangles;
+            i += e.count;
+            continue;
+        }
+
+        auto &box = n->textBox();
+        if (box.height >= minTextHeight)
+        {
+            texts.push_back(n);
+        }
+        else if (box.width >= pixel)
+        {
+            cairo_rectangle(ctx_->cr(), cx(n) - box.width * 0.5, cy(n) - box.height * 0.5, 
+                            box.width, box.height);
+            ++stats_.boxes;
+        }
+        ++i;
+    }
+    cairo_set_source_rgba(ctx_->cr(), 0.0, 0.0, 0.0, 0.5);
+    cairo_fill(ctx_->cr());
+
+    drawTexts(texts);
+}
+
+void Renderer::drawEdges(const NodeArray &nodes)
+{
+    // All edges have one color, they are stroked together in batches.
+    cairo_set_source_rgba(ctx_->cr(), 0.0, 0.0, 0.0, 0.85);
+    std::size_t pathEdges = 0;
+    for (auto n : nodes)
+    {
+        // Edge is from this node to parent node.
+        if (n->parent() == nullptr)
+        {
+            continue;
+        }
+        cairo_move_to(ctx_->cr(), 
+                        cx(n), 
+                        cy(n) - options_.fontSize * 0.45
+                        );
+        cairo_line_to(ctx_->cr(), 
+                        cx(n->parent()), 
+                        cy(n->parent()) + options_.fontSize * 0.45
+                        );
+
+        ++stats_.edges;
+        if (++pathEdges == edgeBatch)
+        {
+            cairo_stroke(ctx_->cr());
+            ++stats_.strokes;
+            pathEdges = 0;
+        }
+    }
+
+    if (pathEdges > 0)
+    {
+        cairo_stroke(ctx_->cr());
+        ++stats_.strokes;
+    }
 }
 
 void Renderer::drawBox(Node *n)
@@ -99,38 +443,89 @@ void Renderer::drawBox(Node *n)
     //cairo_rectangle(ctx_->cr(), cx(n), cy(n), n->textBox().width, n->textBox().height);
 }
 
-void Renderer::drawText(Node *n)
+const Renderer::Color *Renderer::textColor(Node *n)
 {
-    auto getTextColor = [&]()->Color
+    if(!n->property().empty())
     {
-        if(!n->property().empty())
+        auto it = n->property().find("color");
+        if(it != n->property().end())
         {
-            auto it = n->property().find("color");
-            if(it != n->property().end())
+            auto it2 = Renderer::x11ColorMap.find((*it).second);
+            if(it2 !=  Renderer::x11ColorMap.end())
             {
-                auto it2 = Renderer::x11ColorMap.find((*it).second);
-                if(it2 !=  Renderer::x11ColorMap.end())
-                {
-                    return (*it2).second;
-                }
+                return &(*it2).second;
             }
         }
-        return {};
+    }
+    return nullptr;
+}
+
+void Renderer::drawTexts(const NodeArray &nodes)
+{
+    // Labels are grouped by color so the source is set once per color,
+    // groups are drawn in the order of their first label. The default
+    // color is nullptr.
+    std::map<const Color*, std::size_t> groupIndex;
+    std::vector<std::pair<const Color*, NodeArray>> groups;
+    for (auto n : nodes)
+    {
+        auto color = textColor(n);
+        auto it = groupIndex.find(color);
+        if (it == groupIndex.end())
+        {
+            it = groupIndex.emplace(color, groups.size()).first;
+            groups.emplace_back(color, NodeArray());
+        }
+        groups[it->second].second.push_back(n);
+    }
+    stats_.labels += nodes.size();
+    stats_.colorGroups += groups.size();
+
+    // The glyphs of many labels are moved to their nodes and shown in one
+    // run, a run is cut at maxRunGlyphs to bound its memory.
+    static constexpr std::size_t maxRunGlyphs = 16384;
+
+    if (!glyphRuns_)
+    {
+        glyphRuns_ = std::make_shared<GlyphRunCache>();
+    }
+    auto font = cairo_get_scaled_font(ctx_->cr());
+    auto fontFace = ctx_->fontFace();
+    GlyphRunCache::Glyphs run;
+    auto showRun = [&]() {
+        if (!run.empty())
+        {
+            cairo_show_glyphs(ctx_->cr(), run.data(), static_cast<int>(run.size()));
+            run.clear();
+        }
     };
 
-    Color c = getTextColor();
-    cairo_set_source_rgba(ctx_->cr(), c.red, c.green, c.blue, 1.0);
-    cairo_move_to(ctx_->cr(), 
-                cx(n) - n->textBox().width * 0.5 + n->textBox().xBearing, 
-                cy(n) - n->textBox().height * 0.5 - n->textBox().yBearing
-                );
-    cairo_show_text(ctx_->cr(), n->label().c_str());
+    for (auto &group : groups)
+    {
+        Color c = group.first ? *group.first : Color();
+        cairo_set_source_rgba(ctx_->cr(), c.red, c.green, c.blue, 1.0);
+        for (auto n : group.second)
+        {
+            auto x = cx(n) - n->textBox().width * 0.5 + n->textBox().xBearing;
+            auto y = cy(n) - n->textBox().height * 0.5 - n->textBox().yBearing;
+            auto &label = n->label();
+            for (auto &glyph : glyphRuns_->glyphs(font, fontFace, options_.fontSize, StrView(label.data(), label.size())))
+            {
+                run.push_back({glyph.index, glyph.x + x, glyph.y + y});
+            }
+            if (run.size() >= maxRunGlyphs)
+            {
+                showRun();
+            }
+        }
+        showRun();
+    }
 }
 
 void Renderer::saveFile()
 {
     cairo_show_page(ctx_->cr());
-    if (fileType_ == "png" && !fileName_.empty())
+    if (options_.fileType == "png" && !fileName_.empty())
     {
         cairo_surface_write_to_png(ctx_->cs(), fileName_.c_str());
     }
@@ -138,12 +533,12 @@ void Renderer::saveFile()
 
 double Renderer::cx(Node* n)
 {
-    return n->x() + pageMarginW_ - treeSize_.xmin;
+    return n->x() + options_.pageMarginW - treeSize_.xmin;
 }
 
 double Renderer::cy(Node* n)
 {
-    return n->y() + pageMarginH_;
+    return n->y() + options_.pageMarginH;
 }
 
 Box Renderer::getPage()
@@ -151,8 +546,11 @@ Box Renderer::getPage()
     assert(tree_ != nullptr);
 
     Box box;
-    box.width = pageMarginW_ * 2.0 + treeSize_.xmax - treeSize_.xmin;
-    box.height = pageMarginH_ *2.0 + treeSize_.ymax;
+    box.width = options_.pageMarginW * 2.0 + treeSize_.xmax - treeSize_.xmin;
+    box.height = options_.pageMarginH *2.0 + treeSize_.ymax;
+    // A thumbnail is not smaller than the smallest page of CairoContext.
+    box.width = (std::max)(2.0, box.width * options_.scale);
+    box.height = (std::max)(2.0, box.height * options_.scale);
 
     return box;
 }
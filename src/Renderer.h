@@ -19,6 +19,21 @@ namespace cst
     using SyntaxTreePtr = std::shared_ptr<SyntaxTree>;
     class CairoContext;
     using CairoContextPtr = std::shared_ptr<CairoContext>;
+    class GlyphRunCache;
+    using GlyphRunCachePtr = std::shared_ptr<GlyphRunCache>;
+
+    /**
+     * @brief What a renderer has drawn, summed over all tiles.
+     */
+    struct DrawStats
+    {
+        std::size_t edges = {};         ///< Edges added to a path.
+        std::size_t strokes = {};       ///< Edge paths stroked.
+        std::size_t labels = {};        ///< Labels drawn as text.
+        std::size_t colorGroups = {};   ///< Label color groups, the default color is one.
+        std::size_t boxes = {};         ///< Labels too small for text, drawn as boxes.
+        std::size_t triangles = {};     ///< Subtrees thinner than a pixel, drawn as triangles.
+    };
 
     /**
      * @brief Syntax tree renderer.
@@ -26,40 +41,132 @@ namespace cst
     class Renderer
     {
     public:
+        /**
+         * @brief The most edges stroked as one path, a longer path is
+         *        stroked in parts to bound the memory of cairo.
+         */
+        static constexpr std::size_t edgeBatch = 16384;
+
         Renderer(SyntaxTreePtr pSyntaxTree,
                 TreeSize treeSize,
                 std::string fileName,
-                std::string fileType = option::FileType::getFileType(), 
-                double fontSize = option::FontSize::getFontSize(),
-                double pageMarginW =option::PageMargin::getPageMarginW(),
-                double pageMarginH =option::PageMargin::getPageMarginH()
+                const RenderOptions& options = RenderOptions()
+                );
+
+        /**
+         * @brief Construct a renderer which appends one page to a shared context.
+         * 
+         * The context is a pdf context kept open for many trees, drawTree()
+         * resizes its next page to fit this tree. The fonts are embedded once
+         * and the file is written when the last owner of the context is gone.
+         * 
+         * @param[in] pSyntaxTree   The tree.
+         * @param[in] treeSize      The tree size from the layouter.
+         * @param[in] ctx           A pdf context from createBook().
+         * @param[in] options       Options used by the layouter.
+         */
+        Renderer(SyntaxTreePtr pSyntaxTree,
+                TreeSize treeSize,
+                CairoContextPtr ctx,
+                const RenderOptions& options = RenderOptions()
                 );
         
+        /**
+         * @brief Create a pdf context to be shared by many trees.
+         * 
+         * @param[in] fileName      Specify output file name.
+         * @param[in] options       Options used by the layouter.
+         * 
+         * @return CairoContextPtr  The context, or nullptr on failure.
+         */
+        static CairoContextPtr createBook(const std::string &fileName,
+                                          const RenderOptions& options = RenderOptions());
+
+        /**
+         * @brief Create a glyph cache to be shared by the renderers of a job.
+         * 
+         * @return GlyphRunCachePtr     The cache, see setGlyphRunCache().
+         */
+        static GlyphRunCachePtr createGlyphRunCache();
+
         /**
          * @brief Drawing(rendering) the tree.
          * 
+         * A png page is split into tiles of options.tileSize, or of the
+         * automatic tile size if it is larger than one cairo image. Each
+         * tile is written to tileFileName() and only the nodes and edges
+         * crossing it are drawn, one tile surface is alive at a time.
+         * 
+         * All edges are stroked as one path under the labels, and the
+         * labels are drawn grouped by color. A label is converted to glyphs
+         * once, the glyphs of a color group are shown in a few long runs.
+         * 
+         * The page is scaled by options.scale. With options.lodSize a
+         * whole page is drawn in less detail, see drawLod(). Tiles are
+         * always drawn in full detail.
+         * 
          * @return true     Pass.
          * @return false    Fail.
          */
         bool drawTree();
 
+        /**
+         * @brief Get the number of tiles written by drawTree().
+         * 
+         * @return std::size_t  The tile count, 0 if the page is one file.
+         */
+        std::size_t tileCount()const;
+
+        /**
+         * @brief Get the file name of a tile.
+         * 
+         * The tile position goes before the file type, "a.txt.png" =>
+         * "a.txt.r0.c1.png" for row 0 and column 1.
+         * 
+         * @param[in] fileName      The output file name.
+         * @param[in] row           The tile row, from the top.
+         * @param[in] col           The tile column, from the left.
+         * 
+         * @return std::string      The tile file name.
+         */
+        static std::string tileFileName(const std::string &fileName, std::size_t row, std::size_t col);
+        /**
+         * @brief Get what the last drawTree() has drawn.
+         * 
+         * @return const DrawStats&     The counts.
+         */
+        const DrawStats& drawStats()const;
+        /**
+         * @brief Use a glyph cache kept by the caller.
+         * 
+         * A cache kept for a whole job converts each label once for all its
+         * trees. If it is not set, the renderer makes a private one.
+         * 
+         * @param[in] glyphRuns     The cache, or nullptr for a private one.
+         */
+        void setGlyphRunCache(GlyphRunCachePtr glyphRuns);
+
     private:
         SyntaxTreePtr tree_;
         TreeSize treeSize_;
         CairoContextPtr ctx_;
-        std::string fileType_;
+        GlyphRunCachePtr glyphRuns_;
+        const RenderOptions options_;
         std::string fileName_;
-        double fontSize_;
-        double pageMarginW_;
-        double pageMarginH_;
+        bool sharedContext_ = false;
+        std::size_t tileCount_ = {};
+        DrawStats stats_;
 
         int init(const std::string &fileType,const std::string &fileName);
         void internalDrawTree();
+        bool drawTiles(const Box& page, std::size_t tileSize);
         void fillPage();
-        void drawNode(Node* n);
+        void drawNode(Node* t);
+        void drawNodes(const NodeArray& nodes);
+        void drawLod(Node* t);
         void drawBox(Node* n);
-        void drawText(Node* n);
-        void drawEdge(Node* n);
+        void drawTexts(const NodeArray& nodes);
+        void drawEdges(const NodeArray& nodes);
         void saveFile();
         double cx(Node* n);
         double cy(Node* n);
@@ -75,5 +182,6 @@ namespace cst
         };
 
         static const std::map<std::string, Color> x11ColorMap;
+        static const Color* textColor(Node* n);
     };
 } // namespace cst
@@ -0,0 +1,106 @@
+/**
+ * The MIT License
+ *
+ * Copyright 2022 Krishna sssky307@163.com
+ *
+ * For the full copyright and license information, please view the LICENSE
+ * file that was distributed with this source code.
+ */
+
+#include "SpatialIndex.h"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace cst;
+
+constexpr std::size_t SpatialIndex::fanOut;
+
+namespace
+{
+    SpatialIndex::Rect unite(const SpatialIndex::Rect& a, const SpatialIndex::Rect& b)
+    {
+        SpatialIndex::Rect r;
+        r.x0 = (std::min)(a.x0, b.x0);
+        r.y0 = (std::min)(a.y0, b.y0);
+        r.x1 = (std::max)(a.x1, b.x1);
+        r.y1 = (std::max)(a.y1, b.y1);
+        return r;
+    }
+
+    double centerX(const SpatialIndex::Item& item)
+    {
+        return item.rect.x0 + item.rect.x1;
+    }
+
+    double centerY(const SpatialIndex::Item& item)
+    {
+        return item.rect.y0 + item.rect.y1;
+    }
+}
+
+void SpatialIndex::build(std::vector<Item> items)
+{
+    clear();
+    items_ = std::move(items);
+    if (items_.empty())
+    {
+        return;
+    }
+
+    // Sort-Tile-Recursive: sqrt(leaves) vertical slices of whole leaves.
+    auto leafCount = (items_.size() + fanOut - 1) / fanOut;
+    auto sliceCount = static_cast<std::size_t>(std::ceil(std::sqrt(static_cast<double>(leafCount))));
+    auto sliceSize = ((leafCount + sliceCount - 1) / sliceCount) * fanOut;
+
+    std::sort(items_.begin(), items_.end(), [](const Item& a, const Item& b)
+    {
+        return centerX(a) < centerX(b);
+    });
+    for (std::size_t begin = 0; begin < items_.size(); begin += sliceSize)
+    {
+        auto end = (std::min)(begin + sliceSize, items_.size());
+        std::sort(items_.begin() + begin, items_.begin() + end, [](const Item& a, const Item& b)
+        {
+            return centerY(a) < centerY(b);
+        });
+    }
+
+    // Neighbours in the packing order share a parent, up to one root.
+    std::vector<Rect> level(leafCount);
+    for (std::size_t i = 0; i < items_.size(); ++i)
+    {
+        auto& bound = level[i / fanOut];
+        bound = i % fanOut == 0 ? items_[i].rect : unite(bound, items_[i].rect);
+    }
+    levels_.push_back(std::move(level));
+
+    while (levels_.back().size() > 1)
+    {
+        auto& below = levels_.back();
+        std::vector<Rect> above((below.size() + fanOut - 1) / fanOut);
+        for (std::size_t i = 0; i < below.size(); ++i)
+        {
+            auto& bound = above[i / fanOut];
+            bound = i % fanOut == 0 ? below[i] : unite(bound, below[i]);
+        }
+        levels_.push_back(std::move(above));
+    }
+}
+
+void SpatialIndex::clear()
+{
+    items_.clear();
+    levels_.clear();
+}
+
+std::vector<SpatialIndex::Id> SpatialIndex::query(const Rect& rect)const
+{
+    std::vector<Id> ids;
+    query(rect, [&](const Item& item)
+    {
+        ids.push_back(item.id);
+    });
+    std::sort(ids.begin(), ids.end());
+    return ids;
+}
@@ -0,0 +1,161 @@
+/**
+ * The MIT License
+ *
+ * Copyright 2022 Krishna sssky307@163.com
+ *
+ * For the full copyright and license information, please view the LICENSE
+ * file that was distributed with this source code.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace cst
+{
+    /**
+     * @brief A static R-tree of rectangles for range queries.
+     *
+     * It is bulk loaded at once by Sort-Tile-Recursive: the rectangles are
+     * sorted into vertical slices by x, each slice by y, and every fanOut
+     * neighbours share a parent. A query visits only the subtrees whose
+     * bounds intersect the query rectangle.
+     */
+    class SpatialIndex
+    {
+    public:
+        using Id = std::uint32_t;
+
+        /**
+         * @brief A rectangle by its corners, x0 <= x1 and y0 <= y1.
+         */
+        struct Rect
+        {
+            double x0 = {};
+            double y0 = {};
+            double x1 = {};
+            double y1 = {};
+
+            bool intersects(const Rect& other)const
+            {
+                return x0 <= other.x1 && other.x0 <= x1 && y0 <= other.y1 && other.y0 <= y1;
+            }
+        };
+
+        /**
+         * @brief A rectangle and the id it stands for.
+         */
+        struct Item
+        {
+            Rect rect;
+            Id id;
+        };
+
+        static constexpr std::size_t fanOut = 16;
+
+        /**
+         * @brief Replace the content with the items.
+         *
+         * @param[in] items     The items, ids need not be unique or dense.
+         */
+        void build(std::vector<Item> items);
+
+        /**
+         * @brief Remove all items.
+         */
+        void clear();
+
+        /**
+         * @brief Get the item count.
+         */
+        std::size_t size()const
+        {
+            return items_.size();
+        }
+
+        /**
+         * @brief Get the bounds of all items, it is empty if there is none.
+         */
+        Rect bounds()const
+        {
+            return levels_.empty() ? Rect() : levels_.back().front();
+        }
+
+        /**
+         * @brief Visit the items intersecting a rectangle.
+         *
+         * @param[in] rect      The query rectangle.
+         * @param[in] func      Called as func(const Item&) in no particular order.
+         */
+        template <typename Func>
+        void query(const Rect& rect, Func func)const;
+
+        /**
+         * @brief Get the ids of the items intersecting a rectangle.
+         *
+         * @param[in] rect              The query rectangle.
+         * @return std::vector<Id>      The ids in ascending order.
+         */
+        std::vector<Id> query(const Rect& rect)const;
+
+    private:
+        // The items in packing order, and the bounds of every level above
+        // them. Entry i of level k bounds entries [i * fanOut, (i + 1) *
+        // fanOut) of level k - 1, level 0 bounds the items. The last level
+        // is the root.
+        std::vector<Item> items_;
+        std::vector<std::vector<Rect>> levels_;
+    };
+
+    template <typename Func>
+    void SpatialIndex::query(const Rect& rect, Func func)const
+    {
+        if (levels_.empty())
+        {
+            return;
+        }
+
+        // (level, entry), at most fanOut - 1 siblings wait on every level.
+        struct Entry
+        {
+            std::uint32_t level;
+            std::uint32_t index;
+        };
+        Entry stack[fanOut * 20];
+        std::size_t top = 0;
+        stack[top++] = {static_cast<std::uint32_t>(levels_.size() - 1), 0};
+
+        while (top > 0)
+        {
+            auto entry = stack[--top];
+            if (!levels_[entry.level][entry.index].intersects(rect))
+            {
+                continue;
+            }
+
+            std::size_t begin = entry.index * fanOut;
+            if (entry.level == 0)
+            {
+                auto end = begin + fanOut < items_.size() ? begin + fanOut : items_.size();
+                for (auto i = begin; i < end; ++i)
+                {
+                    if (items_[i].rect.intersects(rect))
+                    {
+                        func(items_[i]);
+                    }
+                }
+            }
+            else
+            {
+                auto& below = levels_[entry.level - 1];
+                auto end = begin + fanOut < below.size() ? begin + fanOut : below.size();
+                for (auto i = end; i-- > begin;)
+                {
+                    stack[top++] = {entry.level - 1, static_cast<std::uint32_t>(i)};
+                }
+            }
+        }
+    }
+} // namespace cst
@@ -11,12 +11,14 @@
 
 #include <cassert>
 #include <iostream>
+#include <utility>
+#include <vector>
 
 using namespace cst;
 
 SyntaxTree::SyntaxTree(Node *root) 
-    : root_(root)
 {
+    setRoot(root);
 }
 
 SyntaxTree::~SyntaxTree()
@@ -29,25 +31,74 @@ Node *SyntaxTree::getRoot()const
     return root_;
 }
 
-void SyntaxTree::setRoot(Node *root)
+bool SyntaxTree::setRoot(Node *root)
 {
+    if (root && root->arena() != nullptr && root->arena() != &arena_)
+    {
+        return false;
+    }
+
     freeTree(root_);
     root_ = root;
+    spatialIndex_.clear();
+    indexedNodes_.clear();
+
+    // Nodes from newNode() are numbered in creation order, which is not
+    // dense for a subtree, nor preorder for a parent made after its
+    // children. Checking it costs the same walk as numbering, so every
+    // tree is numbered here.
+    nodeCount_ = 0;
+    if (root_)
+    {
+        NodeArray stack{root_};
+        while (!stack.empty())
+        {
+            auto node = stack.back();
+            stack.pop_back();
+            node->id(nodeCount_++);
+
+            auto &childArray = node->childArray();
+            for (auto it = childArray.rbegin(); it != childArray.rend(); ++it)
+            {
+                stack.push_back(*it);
+            }
+        }
+    }
+
+    return true;
 }
 
-void internalDumpTree(Node *tree, std::size_t depth = 0)
+std::size_t SyntaxTree::size() const
 {
+    return nodeCount_;
+}
+
+void internalDumpTree(Node *tree)
+{
+    // Preorder walk, children are pushed in reverse so the first one is
+    // printed first.
+    std::vector<std::pair<Node *, std::size_t>> stack;
     if (tree)
     {
+        stack.emplace_back(tree, 0);
+    }
+
+    while (!stack.empty())
+    {
+        auto node = stack.back().first;
+        auto depth = stack.back().second;
+        stack.pop_back();
+
         std::cout << std::string(depth * 2, ' ')
-                  << tree->label() << "["
-                  << "x=" << tree->x() <<", "
-                  << "y=" << tree->y() 
+                  << node->label() << "["
+                  << "x=" << node->x() <<", "
+                  << "y=" << node->y() 
                   <<"]\n";
 
-        for (auto &child : tree->childArray())
+        auto &children = node->childArray();
+        for (auto it = children.rbegin(); it != children.rend(); ++it)
         {
-            internalDumpTree(child, depth + 1);
+            stack.emplace_back(*it, depth + 1);
         }
     }
 }
@@ -57,24 +108,114 @@ void SyntaxTree::dumpTree()const
     internalDumpTree(root_);
 }
 
-Node *SyntaxTree::newNode(const std::string& label)
+Node *SyntaxTree::newNode(StrView label)
 {
-    static std::size_t nextId = 0;
-    
-    auto node = new Node(label);
-    node->id(nextId++);
+    // Arena nodes are never destroyed one by one, their members allocate
+    // from the same arena so nothing is leaked.
+    auto node = new (arena_.allocate(sizeof(Node), alignof(Node))) Node(label, {}, &arena_);
+    node->id(nodeCount_++);
     return node;
 }
 
+void SyntaxTree::buildSpatialIndex()
+{
+    spatialIndex_.clear();
+    indexedNodes_.assign(nodeCount_, nullptr);
+
+    std::vector<SpatialIndex::Item> items;
+    items.reserve(nodeCount_);
+    NodeArray stack;
+    if (root_)
+    {
+        stack.push_back(root_);
+    }
+
+    while (!stack.empty())
+    {
+        auto node = stack.back();
+        stack.pop_back();
+
+        // Ids are dense, but a node added after the numbering may be past them.
+        if (node->id() >= indexedNodes_.size())
+        {
+            indexedNodes_.resize(node->id() + 1, nullptr);
+        }
+        indexedNodes_[node->id()] = node;
+
+        SpatialIndex::Item item;
+        item.id = static_cast<SpatialIndex::Id>(node->id());
+        item.rect.x0 = node->x() - node->textBox().width * 0.5;
+        item.rect.x1 = node->x() + node->textBox().width * 0.5;
+        item.rect.y0 = node->y() - node->textBox().height * 0.5;
+        item.rect.y1 = node->y() + node->textBox().height * 0.5;
+        items.push_back(item);
+
+        for (auto &child : node->childArray())
+        {
+            stack.push_back(child);
+        }
+    }
+
+    spatialIndex_.build(std::move(items));
+}
+
+Node *SyntaxTree::nodeAt(double x, double y) const
+{
+    SpatialIndex::Rect point;
+    point.x0 = point.x1 = x;
+    point.y0 = point.y1 = y;
+
+    Node *found = nullptr;
+    spatialIndex_.query(point, [&](const SpatialIndex::Item &item) {
+        auto node = indexedNodes_[item.id];
+        if (!found || node->id() > found->id())
+        {
+            found = node;
+        }
+    });
+    return found;
+}
+
+NodeArray SyntaxTree::nodesIn(double x0, double y0, double x1, double y1) const
+{
+    SpatialIndex::Rect rect;
+    rect.x0 = x0;
+    rect.y0 = y0;
+    rect.x1 = x1;
+    rect.y1 = y1;
+
+    NodeArray nodes;
+    for (auto id : spatialIndex_.query(rect))
+    {
+        nodes.push_back(indexedNodes_[id]);
+    }
+    return nodes;
+}
+
+const Arena &SyntaxTree::arena() const
+{
+    return arena_;
+}
+
 void internalFreeTree(Node *treeRoot)
 {
+    // A node is deleted as soon as its children are on the stack, so the
+    // stack never holds more than the nodes still to be deleted.
+    NodeArray stack;
     if (treeRoot)
     {
-        for (auto &child : treeRoot->childArray())
+        stack.push_back(treeRoot);
+    }
+
+    while (!stack.empty())
+    {
+        auto node = stack.back();
+        stack.pop_back();
+        for (auto &child : node->childArray())
         {
-            internalFreeTree(child);
+            stack.push_back(child);
         }
-        delete treeRoot;
+        delete node;
     }
 }
 
@@ -82,7 +223,11 @@ void SyntaxTree::freeTree(Node *&treeRoot)
 {
     if (treeRoot)
     {
-        internalFreeTree(treeRoot);
+        // A tree is all arena nodes or all heap nodes.
+        if (treeRoot->arena() == nullptr)
+        {
+            internalFreeTree(treeRoot);
+        }
         treeRoot = nullptr;
     }
 }
@@ -10,6 +10,7 @@
 #pragma once
 
 #include "BaseType.h"
+#include "SpatialIndex.h"
 
 #include <string>
 #include <vector>
@@ -22,19 +23,49 @@ namespace cst
      * @brief The syntax tree.
      * 
      * Manage a syntax tree's life time.
+     * 
+     * Nodes made by newNode() live in the tree arena, building a tree is a
+     * few large allocations and destroying it releases them in bulk. A tree
+     * of heap nodes can also be adopted, it is then freed node by node.
      */
     class SyntaxTree
     {
     public:
+        /**
+         * @brief Construct a tree.
+         * 
+         * @param[in] root  A tree to adopt, see setRoot().
+         */
         SyntaxTree(Node* root = nullptr);
         ~SyntaxTree();
 
+        SyntaxTree(const SyntaxTree&) = delete;
+        SyntaxTree& operator=(const SyntaxTree&) = delete;
+
         /**
          * @brief Set the tree root.
          * 
+         * A tree which is not made by newNode() of this tree is adopted. The
+         * node ids are renumbered in preorder, a null root leaves an empty
+         * tree. A root in the arena of another tree is rejected, that arena
+         * owns it.
+         * 
          * @param[in] root The tree root.
+         * 
+         * @return true     Pass.
+         * @return false    The root belongs to another arena, the tree is
+         *                  not changed.
          */
-        void setRoot(Node* root);
+        bool setRoot(Node* root);
+
+        /**
+         * @brief Get the node count.
+         * 
+         * Node ids are dense in [0, size()), they can index side arrays.
+         * 
+         * @return std::size_t  The node count.
+         */
+        std::size_t size()const;
 
         /**
          * @brief Get the tree root.
@@ -50,20 +81,68 @@ namespace cst
         void dumpTree()const;
 
         /**
-         * @brief Create new tree node.
+         * @brief Create new tree node in the tree arena.
+         * 
+         * The node is owned by this tree and lives as long as it does, its
+         * id is the count of nodes made before it.
          * 
          * @param[in] label     The node label.
          * @return Node*        The new node.
          */
-        static Node* newNode(const std::string& label);
+        Node* newNode(StrView label);
+
+        /**
+         * @brief Get the arena of the tree nodes.
+         * 
+         * @return const Arena&     The arena.
+         */
+        const Arena& arena()const;
         
+        /**
+         * @brief Index the label boxes of the laid out nodes.
+         * 
+         * A label box is centered on the node position, the same layout
+         * coordinates as Node::x() and Node::y(). Build it again after the
+         * tree is laid out again or changed, setRoot() drops it.
+         */
+        void buildSpatialIndex();
+
+        /**
+         * @brief Find the node whose label box contains a point.
+         * 
+         * @param[in] x     The x in layout coordinates.
+         * @param[in] y     The y in layout coordinates.
+         * @return Node*    The node, nullptr if there is none or the index
+         *                  is not built. Of overlapping boxes the node with
+         *                  the greatest id is picked.
+         */
+        Node* nodeAt(double x, double y)const;
+
+        /**
+         * @brief Find the nodes whose label boxes intersect a rectangle.
+         * 
+         * @param[in] x0    The left side in layout coordinates.
+         * @param[in] y0    The top side in layout coordinates.
+         * @param[in] x1    The right side, x1 >= x0.
+         * @param[in] y1    The bottom side, y1 >= y0.
+         * @return NodeArray    The nodes in ascending id order, empty if the
+         *                      index is not built.
+         */
+        NodeArray nodesIn(double x0, double y0, double x1, double y1)const;
+
         /**
          * @brief Free the tree.
          * 
+         * Heap nodes are deleted, arena nodes are left to their arena.
+         * 
          * @param treeRoot  The tree root.
          */
         static void freeTree(Node*& treeRoot);
     private:
+        Arena arena_;
         Node *root_ = nullptr;
+        std::size_t nodeCount_ = {};
+        SpatialIndex spatialIndex_;
+        std::vector<Node*> indexedNodes_;    ///< Indexed nodes by id.
     }; // SyntaxTree end.
 } // namespace cst
@@ -0,0 +1,167 @@
+/**
+ * The MIT License
+ *
+ * Copyright 2022 Krishna sssky307@163.com
+ *
+ * For the full copyright and license information, please view the LICENSE
+ * file that was distributed with this source code.
+ */
+
+#include "TextBoxCache.h"
+
+#include <fstream>
+#include <limits>
+#include <sstream>
+
+using namespace cst;
+
+constexpr std::size_t TextBoxCache::shardCount;
+
+namespace
+{
+    // The first line of a cache file.
+    const char* fileHeader = "cpp-syntax-tree textbox cache 2";
+
+    // The longest font face or label read from a cache file.
+    constexpr std::size_t maxStringSize = 1 << 20;
+}
+
+TextBoxCache::Shard& TextBoxCache::shardOf(const LabelKey& key)
+{
+    // The low bits pick the bucket inside the map, use the high ones here.
+    return shards_[(LabelKeyHash()(key) >> 16) % shardCount];
+}
+
+bool TextBoxCache::find(StrView label, double fontSize, StrView fontFace, TextBox& textBox)
+{
+    LabelKey key{label, fontFace, fontSize};
+    auto& shard = shardOf(key);
+    {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        auto found = shard.map.find(key);
+        if (found)
+        {
+            textBox = *found;
+            hits_.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+
+    misses_.fetch_add(1, std::memory_order_relaxed);
+    return false;
+}
+
+void TextBoxCache::insert(StrView label, double fontSize, StrView fontFace, const TextBox& textBox)
+{
+    LabelKey key{label, fontFace, fontSize};
+    auto& shard = shardOf(key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto result = shard.map.emplace(key, textBox);
+    if (!result.second)
+    {
+        *result.first = textBox;
+    }
+}
+
+std::size_t TextBoxCache::size()const
+{
+    std::size_t n = 0;
+    for (auto& shard : shards_)
+    {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        n += shard.map.size();
+    }
+    return n;
+}
+
+void TextBoxCache::clear()
+{
+    for (auto& shard : shards_)
+    {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        shard.map.clear();
+    }
+    hits_ = 0;
+    misses_ = 0;
+}
+
+double TextBoxCache::hitRate()const
+{
+    auto h = hits();
+    auto lookups = h + misses();
+    return lookups == 0 ? 0.0 : static_cast<double>(h) / lookups;
+}
+
+//
+// One textbox per line:
+//   faceSize fontFace fontSize width height xBearing yBearing labelSize label
+// The font face and the label are written as is after one space, their sizes
+// tell where they end, so a raw string label can hold spaces and new lines.
+//
+bool TextBoxCache::load(const std::string& fileName)
+{
+    std::ifstream ifs(fileName, std::ios::binary);
+    if (!ifs)
+        return false;
+
+    std::string line;
+    if (!std::getline(ifs, line) || line != fileHeader)
+        return false;
+
+    while (true)
+    {
+        std::size_t faceSize;
+        double fontSize;
+        TextBox textBox;
+        std::size_t labelSize;
+        if (!(ifs >> faceSize))
+            return ifs.eof();
+        // A size from the file is not allocated before it is bounded.
+        if (faceSize > maxStringSize || ifs.get() != ' ')
+            return false;
+
+        std::string fontFace(faceSize, '\0');
+        if (faceSize > 0 && !ifs.read(&fontFace[0], faceSize))
+            return false;
+        if (!(ifs >> fontSize >> textBox.width >> textBox.height >> textBox.xBearing >> textBox.yBearing >> labelSize))
+            return false;
+        if (labelSize > maxStringSize || ifs.get() != ' ')
+            return false;
+
+        std::string label(labelSize, '\0');
+        if (!ifs.read(&label[0], labelSize) || ifs.get() != '\n')
+            return false;
+
+        insert(label, fontSize, fontFace, textBox);
+    }
+}
+
+bool TextBoxCache::save(const std::string& fileName)const
+{
+    std::ostringstream oss;
+    oss.precision(std::numeric_limits<double>::max_digits10);
+    oss << fileHeader << '\n';
+    for (auto& shard : shards_)
+    {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        for (auto& item : shard.map)
+        {
+            auto& key = item.first;
+            auto& textBox = item.second;
+            oss << key.fontFace.size() << ' ';
+            oss.write(key.fontFace.data(), key.fontFace.size());
+            oss << ' ' << key.fontSize << ' '
+                << textBox.width << ' ' << textBox.height << ' '
+                << textBox.xBearing << ' ' << textBox.yBearing << ' '
+                << key.label.size() << ' ';
+            oss.write(key.label.data(), key.label.size());
+            oss << '\n';
+        }
+    }
+
+    std::ofstream ofs(fileName, std::ios::binary);
+    if (!ofs)
+        return false;
+    ofs << oss.str();
+    return static_cast<bool>(ofs.flush());
+}
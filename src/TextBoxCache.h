@@ -0,0 +1,126 @@
+/**
+ * The MIT License
+ *
+ * Copyright 2022 Krishna sssky307@163.com
+ *
+ * For the full copyright and license information, please view the LICENSE
+ * file that was distributed with this source code.
+ */
+
+#pragma once
+
+#include "BaseType.h"
+#include "LabelMap.h"
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <string>
+
+namespace cst
+{
+    /**
+     * @brief A thread-safe cache of label textboxes by (label, font face, font size).
+     *
+     * Syntax trees repeat a small vocabulary of labels (NP, VP, DT, ...), so
+     * most labels are measured only once. One cache can be shared by the
+     * Boxy objects of many threads, the map is split into shards which are
+     * locked separately. It can be saved to and loaded from a text file.
+     */
+    class TextBoxCache
+    {
+    public:
+        TextBoxCache() = default;
+        TextBoxCache(const TextBoxCache&) = delete;
+        TextBoxCache& operator=(const TextBoxCache&) = delete;
+
+        /**
+         * @brief Find a textbox.
+         *
+         * The lookup does not copy the label.
+         *
+         * @param[in] label     The label.
+         * @param[in] fontSize  The font size it is measured with.
+         * @param[in] fontFace  The font face family it is measured with.
+         * @param[out] textBox  The textbox if found.
+         *
+         * @return true         Found, it counts as a hit.
+         * @return false        Not found, it counts as a miss.
+         */
+        bool find(StrView label, double fontSize, StrView fontFace, TextBox& textBox);
+
+        /**
+         * @brief Add or replace a textbox.
+         *
+         * @param[in] label     The label.
+         * @param[in] fontSize  The font size it is measured with.
+         * @param[in] fontFace  The font face family it is measured with.
+         * @param[in] textBox   The textbox.
+         */
+        void insert(StrView label, double fontSize, StrView fontFace, const TextBox& textBox);
+
+        /**
+         * @brief Get the number of textboxes.
+         */
+        std::size_t size()const;
+
+        /**
+         * @brief Remove all textboxes and reset the counters.
+         */
+        void clear();
+
+        /**
+         * @brief Get the number of found lookups.
+         */
+        std::size_t hits()const { return hits_.load(std::memory_order_relaxed); }
+
+        /**
+         * @brief Get the number of not found lookups.
+         */
+        std::size_t misses()const { return misses_.load(std::memory_order_relaxed); }
+
+        /**
+         * @brief Get hits / lookups, it is 0 if there is no lookup.
+         */
+        double hitRate()const;
+
+        /**
+         * @brief Add the textboxes of a file saved by save().
+         *
+         * @param[in] fileName  The file name.
+         *
+         * @return true         Pass.
+         * @return false        The file can not be read or it is malformed,
+         *                      the entries before the error are kept.
+         */
+        bool load(const std::string& fileName);
+
+        /**
+         * @brief Save all textboxes to a file.
+         *
+         * @param[in] fileName  The file name.
+         *
+         * @return true         Pass.
+         * @return false        The file can not be written.
+         */
+        bool save(const std::string& fileName)const;
+
+    private:
+        struct Shard
+        {
+            mutable std::mutex mutex;
+            LabelMap<TextBox> map;
+        };
+
+        static constexpr std::size_t shardCount = 16;
+
+        Shard shards_[shardCount];
+        std::atomic<std::size_t> hits_{0};
+        std::atomic<std::size_t> misses_{0};
+
+        Shard& shardOf(const LabelKey& key);
+    };
+
+    using TextBoxCachePtr = std::shared_ptr<TextBoxCache>;
+} // namespace cst
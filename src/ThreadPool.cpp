@@ -0,0 +1,125 @@
+/**
+ * The MIT License
+ *
+ * Copyright 2022 Krishna sssky307@163.com
+ *
+ * For the full copyright and license information, please view the LICENSE
+ * file that was distributed with this source code.
+ */
+
+#include "ThreadPool.h"
+
+using namespace cst;
+
+ThreadPool::ThreadPool(std::size_t size)
+{
+    if (size == 0)
+    {
+        size = std::thread::hardware_concurrency();
+    }
+
+    for (std::size_t worker = 1; worker < size; ++worker)
+    {
+        threads_.emplace_back(&ThreadPool::workerLoop, this, worker);
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    wake_.notify_all();
+
+    for (auto& thread : threads_)
+    {
+        thread.join();
+    }
+}
+
+std::size_t ThreadPool::size() const
+{
+    return threads_.size() + 1;
+}
+
+void ThreadPool::parallelFor(std::size_t count, const Task& task)
+{
+    if (count == 0)
+    {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        task_ = &task;
+        count_ = count;
+        next_ = 0;
+        busy_ = threads_.size();
+        error_ = nullptr;
+        ++generation_;
+    }
+    wake_.notify_all();
+
+    runTasks(0);
+
+    std::exception_ptr error;
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        done_.wait(lock, [this]() { return busy_ == 0; });
+        task_ = nullptr;
+        error = error_;
+    }
+
+    if (error)
+    {
+        std::rethrow_exception(error);
+    }
+}
+
+void ThreadPool::workerLoop(std::size_t worker)
+{
+    std::size_t seen = 0;
+    while (true)
+    {
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            wake_.wait(lock, [&]() { return stop_ || generation_ != seen; });
+            if (stop_)
+            {
+                return;
+            }
+            seen = generation_;
+        }
+
+        runTasks(worker);
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (--busy_ == 0)
+            {
+                done_.notify_all();
+            }
+        }
+    }
+}
+
+void ThreadPool::runTasks(std::size_t worker)
+{
+    std::size_t index;
+    while ((index = next_++) < count_)
+    {
+        try
+        {
+            (*task_)(index, worker);
+        }
+        catch (...)
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (!error_)
+            {
+                error_ = std::current_exception();
+            }
+        }
+    }
+}
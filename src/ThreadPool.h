@@ -0,0 +1,85 @@
+/**
+ * The MIT License
+ *
+ * Copyright 2022 Krishna sssky307@163.com
+ *
+ * For the full copyright and license information, please view the LICENSE
+ * file that was distributed with this source code.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace cst
+{
+    /**
+     * @brief A fixed set of worker threads running indexed tasks.
+     *
+     * The calling thread is worker 0 and joins the work, so a pool of size
+     * 1 runs everything inline. Worker ids are dense, they can index
+     * per-thread state such as a Layouter or a Boxy.
+     */
+    class ThreadPool
+    {
+    public:
+        using Task = std::function<void(std::size_t index, std::size_t worker)>;
+
+        /**
+         * @brief Start the worker threads.
+         *
+         * @param[in] size  Worker count including the calling thread, 0 is
+         *                  the hardware thread count.
+         */
+        explicit ThreadPool(std::size_t size = 0);
+
+        /**
+         * @brief Stop and join the worker threads.
+         */
+        ~ThreadPool();
+
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+
+        /**
+         * @brief Get the worker count including the calling thread.
+         *
+         * @return std::size_t  The worker count.
+         */
+        std::size_t size()const;
+
+        /**
+         * @brief Run task(index, worker) for every index in [0, count).
+         *
+         * It returns when all tasks are done, the first exception thrown by
+         * a task is rethrown here.
+         *
+         * @param[in] count     The task count.
+         * @param[in] task      The task.
+         */
+        void parallelFor(std::size_t count, const Task& task);
+
+    private:
+        std::vector<std::thread> threads_;
+        std::mutex mutex_;
+        std::condition_variable wake_;
+        std::condition_variable done_;
+        const Task* task_ = nullptr;
+        std::size_t count_ = {};
+        std::atomic<std::size_t> next_{0};
+        std::size_t busy_ = {};
+        std::size_t generation_ = {};
+        std::exception_ptr error_;
+        bool stop_ = false;
+
+        void workerLoop(std::size_t worker);
+        void runTasks(std::size_t worker);
+    };
+} // namespace cst
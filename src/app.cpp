@@ -11,11 +11,25 @@
 #include "Parser.h"
 #include "Layouter.h"
 #include "Renderer.h"
+#include "InputFile.h"
+#include "ThreadPool.h"
+#include "TextBoxCache.h"
+#include "GlyphMetrics.h"
 
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
 #include <iostream>
+#include <memory>
+#include <mutex>
 #include <stdexcept>
 #include <fstream>
 #include <string>
+#include <vector>
+
+#ifndef _WIN32
+#include <glob.h>
+#endif
 
 using namespace cst;
 
@@ -30,25 +44,38 @@ void GetDotStreamHelper(Node *node, std::string &stream)
     static const std::string indent(4, ' ');
     static const std::string indent2(8, ' ');
 
-    std::string nodeId = std::to_string(node->id());
-    stream += indent + nodeId;
-    if (node->cppRawStr().empty())
-    {
-        stream += "[label = \"" + node->label() + "\"];\n";
-    }
-    else
+    // Preorder, children are pushed in reverse to keep the output order.
+    std::vector<Node *> stack{node};
+    while (!stack.empty())
     {
-        stream += "[" + node->cppRawStr() + "];\n";
-    }
+        node = stack.back();
+        stack.pop_back();
 
-    for (auto const &child : node->childArray())
-    {
-        stream += indent2 + nodeId + " -> " + std::to_string(child->id()) + ";\n";
-    }
+        std::string nodeId = std::to_string(node->id());
+        stream += indent + nodeId;
+        if (node->cppRawStr().empty())
+        {
+            stream += "[label = \"";
+            stream.append(node->label().data(), node->label().size());
+            stream += "\"];\n";
+        }
+        else
+        {
+            stream += "[";
+            stream.append(node->cppRawStr().data(), node->cppRawStr().size());
+            stream += "];\n";
+        }
 
-    for (auto const &child : node->childArray())
-    {
-        GetDotStreamHelper(child, stream);
+        for (auto const &child : node->childArray())
+        {
+            stream += indent2 + nodeId + " -> " + std::to_string(child->id()) + ";\n";
+        }
+
+        auto &childArray = node->childArray();
+        for (auto it = childArray.rbegin(); it != childArray.rend(); ++it)
+        {
+            stack.push_back(*it);
+        }
     }
 }
 
@@ -95,74 +122,398 @@ void SaveStreamToFile(const std::string &stream, const std::string &fileName)
     ofs.close();
 }
 
+/**
+ * @brief Get the output file name of the n-th tree of a multi-tree input.
+ *
+ * The number goes before the file type, "a.txt.pdf" => "a.txt.1.pdf".
+ *
+ * @param[in] oFile     The output file name.
+ * @param[in] n         The tree number, it begins with 1.
+ *
+ * @return std::string  The numbered file name.
+ */
+std::string NumberedFileName(const std::string &oFile, std::size_t n)
+{
+    auto dot = oFile.find_last_of('.');
+    auto slash = oFile.find_last_of("/\\");
+    if (dot == std::string::npos || (slash != std::string::npos && dot < slash))
+        return oFile + "." + std::to_string(n);
+    return oFile.substr(0, dot) + "." + std::to_string(n) + oFile.substr(dot);
+}
+
+/**
+ * @brief Get the output names of a work for logging.
+ *
+ * @param[in] oFile     The output file name.
+ * @param[in] treeCount The number of trees drawn.
+ * @param[in] options   Options of this work.
+ * @param[in] tileCount The number of png tiles written, 0 if none.
+ *
+ * @return std::string  The output names.
+ */
+std::string OutputNames(const std::string &oFile, 
+                        std::size_t treeCount, 
+                        const RenderOptions &options, 
+                        std::size_t tileCount = 0)
+{
+    if (tileCount > 0)
+    {
+        auto tiles = std::to_string(tileCount) + (tileCount == 1 ? " tile)" : " tiles)");
+        if (treeCount == 1)
+            return Renderer::tileFileName(oFile, 0, 0) + " ... (" + tiles;
+        return Renderer::tileFileName(NumberedFileName(oFile, 1), 0, 0) + " ... (" 
+            + std::to_string(treeCount) + " trees, " + tiles;
+    }
+    if (treeCount == 1)
+        return oFile;
+    if (options.fileType == "pdf")
+        return oFile + " (" + std::to_string(treeCount) + " pages)";
+    return NumberedFileName(oFile, 1) + " ... " + NumberedFileName(oFile, treeCount) 
+        + " (" + std::to_string(treeCount) + " trees)";
+}
+
+/**
+ * @brief Layout one tree and save it to oFile, or append it to a pdf book.
+ *
+ * @param[in] glyphRuns The glyph cache of the job, or nullptr.
+ * @param[in] book      A pdf context shared by many trees, or nullptr.
+ *
+ * @return std::size_t  The number of png tiles written, 0 if none.
+ *
+ * @exception std::runtime_error    Work fail.
+ */
+std::size_t DrawTree(const SyntaxTreePtr &tree, 
+                     const std::string &oFile, 
+                     const RenderOptions &options, 
+                     Layouter &layouter,
+                     const GlyphRunCachePtr &glyphRuns,
+                     const CairoContextPtr &book = nullptr)
+{
+    TreeSize treeSize;
+    if (!layouter.layout(tree->getRoot(), treeSize))
+    {
+        throw std::runtime_error("layouter.layout tree failed.");
+    }
+
+    if (options.fileType == "dot")
+    {
+        SaveStreamToFile(GetDotStream(tree->getRoot()), oFile);
+        return 0;
+    }
+
+    auto renderer = book ? Renderer(tree, treeSize, book, options) 
+                         : Renderer(tree, treeSize, oFile, options);
+    renderer.setGlyphRunCache(glyphRuns);
+    if (!renderer.drawTree())
+    {
+        throw std::runtime_error("renderer.drawTree failed.");
+    }
+    return renderer.tileCount();
+}
+
+/**
+ * @brief Draw trees from iFile and save result to oFile.
+ *
+ * An input file may hold many top-level trees. They are parsed one by one
+ * and each tree is drawn as soon as it is parsed. A pdf output gets one page
+ * per tree in oFile, other types get numbered output files (see
+ * NumberedFileName). A file with one tree is saved to oFile itself.
+ * Regular files are mapped, a pipe or /dev/stdin is parsed as a stream.
+ *
+ * @param[in] iFile     Specify input file name.
+ * @param[in] oFile     Speicfy output file name.
+ * @param[in] options   Options of this work.
+ * @param[in] layouter  A layouter made with the same options, it can be
+ *                      reused by the works of one thread.
+ * @param[in] glyphRuns A glyph cache, it can be reused by the works of one
+ *                      thread like the layouter.
+ * @param[out] tileCount The number of png tiles written, 0 if none.
+ *
+ * @return std::size_t  The number of trees drawn.
+ *
+ * @exception std::runtime_error    Work fail.
+ */
+std::size_t DrawFile(const std::string &iFile, 
+                     const std::string &oFile, 
+                     const RenderOptions &options, 
+                     Layouter &layouter,
+                     const GlyphRunCachePtr &glyphRuns,
+                     std::size_t &tileCount)
+{
+    tileCount = 0;
+    std::unique_ptr<InputFile> input;
+    std::ifstream stream;
+    std::unique_ptr<TreeReader> readerPtr;
+    if (InputFile::isRegularFile(iFile))
+    {
+        input.reset(new InputFile(iFile));
+        if (!input->good())
+            throw std::runtime_error("Cannot read file => " + iFile);
+
+        if (input->size() == 0)
+        {
+            throw std::runtime_error("Read empty file => " + iFile);
+        }
+
+        readerPtr.reset(new TreeReader(input->data(), input->size(), options.maxTreeDepth));
+    }
+    else
+    {
+        // Pipes and stdin are lexed chunk by chunk instead of read as a whole.
+        stream.open(iFile, std::ios::binary);
+        if (!stream)
+            throw std::runtime_error("Cannot read file => " + iFile);
+
+        readerPtr.reset(new TreeReader(stream, options.maxTreeDepth));
+    }
+
+    auto &reader = *readerPtr;
+    auto tree = reader.next();
+    if (tree == nullptr)
+    {
+        if (reader.good() && !input)
+            throw std::runtime_error("Read empty file => " + iFile);
+        throw std::runtime_error("Parser::buildSyntaxTree failed");
+    }
+
+    // One tree of lookahead tells whether the outputs are numbered.
+    auto nextTree = reader.next();
+    if (nextTree == nullptr && reader.good())
+    {
+        tileCount = DrawTree(tree, oFile, options, layouter, glyphRuns);
+        return 1;
+    }
+
+    // All pages share one pdf surface, so the fonts are embedded only once.
+    CairoContextPtr book;
+    if (options.fileType == "pdf")
+    {
+        book = Renderer::createBook(oFile, options);
+        if (!book)
+            throw std::runtime_error("Cannot create pdf => " + oFile);
+    }
+
+    std::size_t n = 0;
+    while (tree)
+    {
+        ++n;
+        tileCount += DrawTree(tree, book ? oFile : NumberedFileName(oFile, n), options, layouter, glyphRuns, book);
+        tree = std::move(nextTree);
+        if (tree)
+            nextTree = reader.next();
+    }
+
+    if (!reader.good())
+    {
+        throw std::runtime_error("Parser::buildSyntaxTree failed at tree " + std::to_string(n + 1));
+    }
+
+    return n;
+}
+
 /**
  * @brief Draw tree from iFile and save result to oFile.
  *
  * @param[in] iFile     Specify input file name.
  * @param[in] oFile     Speicfy output file name.
+ * @param[in] options   Options of this work.
+ * @param[in] cache     The textbox cache.
+ * @param[in] metrics   The glyph metrics, or nullptr to measure by cairo.
+ * @param[in] jobs      Thread count for measuring labels of large trees.
  *
  * @return 0            Work pass.
  * @return other        Work fail.
  */
-int DoWork(std::string iFile, std::string oFile)
+int DoWork(std::string iFile, 
+           std::string oFile, 
+           const RenderOptions &options, 
+           const TextBoxCachePtr &cache,
+           const GlyphMetricsPtr &metrics,
+           std::size_t jobs)
 {
     if (iFile.empty())
         return 0;
     if (oFile.empty())
-        oFile = iFile + "." + option::FileType::getFileType();
+        oFile = iFile + "." + options.fileType;
 
+    std::size_t treeCount = 0;
+    std::size_t tileCount = 0;
     try
     {
-        std::ifstream ifs(iFile);
-        if (!ifs)
-            throw std::runtime_error("Cannot read file => " + iFile);
-
-        std::istreambuf_iterator<char> begin(ifs);
-        std::istreambuf_iterator<char> end;
-        std::string stream(begin, end);
-        if (stream.empty())
+        Layouter layouter(options, cache, metrics);
+        std::unique_ptr<ThreadPool> pool;
+        if (jobs > 1)
         {
-            throw std::runtime_error("Read empty file => " + iFile);
+            pool.reset(new ThreadPool(jobs));
+            layouter.setThreadPool(pool.get());
         }
+        treeCount = DrawFile(iFile, oFile, options, layouter, Renderer::createGlyphRunCache(), tileCount);
+    }
+    catch (const std::exception &e)
+    {
+        std::cout << "[cpp-syntax-tree]\n";
+        std::cout << "[error] " << e.what() << std::endl;
+        return 1;
+    }
 
-        auto tree = Parser::buildSyntaxTree(stream);
-        if (tree == nullptr)
+    std::cout << "[cpp-syntax-tree]\n";
+    std::cout << "[input ] " << iFile << std::endl;
+    std::cout << "[output] " << OutputNames(oFile, treeCount, options, tileCount) << std::endl;
+
+    return 0;
+}
+
+/**
+ * @brief Draw trees from many input files on a thread pool.
+ *
+ * Each thread reuses one Layouter and one glyph cache. All threads share one textbox cache and
+ * one set of glyph metrics, so a label is measured once for the whole
+ * batch. The output of a file is the input file name with the file type
+ * appended.
+ *
+ * @param[in] iFiles    Specify input file names.
+ * @param[in] options   Options of this work.
+ * @param[in] jobs      Thread count.
+ * @param[in] cache     The textbox cache.
+ * @param[in] metrics   The glyph metrics, or nullptr to measure by cairo.
+ *
+ * @return 0            All work pass.
+ * @return other        Some work fail.
+ */
+int DoBatchWork(const std::vector<std::string> &iFiles, 
+                const RenderOptions &options, 
+                std::size_t jobs, 
+                const TextBoxCachePtr &cache,
+                const GlyphMetricsPtr &metrics)
+{
+    ThreadPool pool((std::min)(jobs, iFiles.size()));
+    std::vector<std::unique_ptr<Layouter>> layouters(pool.size());
+    std::vector<GlyphRunCachePtr> glyphRuns(pool.size());
+    std::mutex outputMutex;
+    std::size_t failed = 0;
+
+    std::cout << "[cpp-syntax-tree]\n";
+
+    auto t0 = std::chrono::steady_clock::now();
+    pool.parallelFor(iFiles.size(), [&](std::size_t index, std::size_t worker)
+    {
+        auto &iFile = iFiles[index];
+        auto oFile = iFile + "." + options.fileType;
+        auto begin = std::chrono::steady_clock::now();
+
+        std::string error;
+        std::size_t treeCount = 0;
+        std::size_t tileCount = 0;
+        try
         {
-            throw std::runtime_error("Parser::buildSyntaxTree failed");
+            if (!layouters[worker])
+            {
+                layouters[worker].reset(new Layouter(options, cache, metrics));
+                glyphRuns[worker] = Renderer::createGlyphRunCache();
+            }
+            treeCount = DrawFile(iFile, oFile, options, *layouters[worker], glyphRuns[worker], tileCount);
         }
-
-        Layouter layouter;
-        TreeSize treeSize;
-        if (!layouter.layout(tree->getRoot(), treeSize))
+        catch (const std::exception &e)
         {
-            throw std::runtime_error("layouter.layout tree failed.");
+            error = e.what();
         }
 
-        if (option::FileType::getFileType() == "dot")
+        auto ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count();
+
+        std::lock_guard<std::mutex> lock(outputMutex);
+        if (error.empty())
         {
-            SaveStreamToFile(GetDotStream(tree->getRoot()), oFile);
+            std::cout << "[done  ] " << iFile << " => " << OutputNames(oFile, treeCount, options, tileCount) 
+                      << " (" << ms << " ms)\n";
         }
         else
         {
-            Renderer renderer(tree, treeSize, oFile);
-            if (!renderer.drawTree())
+            std::cout << "[error ] " << iFile << ": " << error << "\n";
+            ++failed;
+        }
+    });
+    auto seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+    std::cout << "[total ] " << iFiles.size() << " files, "
+              << failed << " failed, "
+              << pool.size() << " jobs, "
+              << seconds << " s, "
+              << iFiles.size() / seconds << " files/s" << std::endl;
+
+    return failed == 0 ? 0 : 1;
+}
+
+/**
+ * @brief Show the textbox cache usage.
+ *
+ * @param[in] cache     The textbox cache.
+ */
+void ShowCacheStat(const TextBoxCache &cache)
+{
+    std::cout << "[cache ] " << cache.size() << " labels, "
+              << cache.hits() << " hits, "
+              << cache.misses() << " misses, "
+              << cache.hitRate() * 100.0 << "% hit rate" << std::endl;
+}
+
+/**
+ * @brief Add input files, a pattern with wildcards is expanded.
+ *
+ * @param[in] name      A file name or a glob pattern.
+ * @param[out] iFiles   Input file names.
+ */
+void AddInputFiles(const std::string &name, std::vector<std::string> &iFiles)
+{
+#ifndef _WIN32
+    if (name.find_first_of("*?[") != std::string::npos)
+    {
+        glob_t result;
+        if (glob(name.c_str(), 0, nullptr, &result) == 0)
+        {
+            for (std::size_t i = 0; i < result.gl_pathc; ++i)
             {
-                throw std::runtime_error("renderer.drawTree failed.");
+                iFiles.push_back(result.gl_pathv[i]);
             }
+            globfree(&result);
+            return;
         }
+        globfree(&result);
     }
-    catch (const std::exception &e)
-    {
-        std::cout << "[cpp-syntax-tree]\n";
-        std::cout << "[error] " << e.what() << std::endl;
-        return 1;
-    }
+#endif
+    iFiles.push_back(name);
+}
 
-    std::cout << "[cpp-syntax-tree]\n";
-    std::cout << "[input ] " << iFile << std::endl;
-    std::cout << "[output] " << oFile << std::endl;
+/**
+ * @brief Read input files from a manifest file.
+ *
+ * Every non-empty line is an input file name or pattern, a line begin with
+ * '#' is a comment.
+ *
+ * @param[in] fileName  The manifest file name.
+ * @param[out] iFiles   Input file names.
+ *
+ * @return true         Pass.
+ * @return false        Cannot read the manifest file.
+ */
+bool ReadManifest(const std::string &fileName, std::vector<std::string> &iFiles)
+{
+    std::ifstream ifs(fileName);
+    if (!ifs)
+        return false;
 
-    return 0;
+    std::string line;
+    while (std::getline(ifs, line))
+    {
+        if (!line.empty() && line.back() == '\r')
+        {
+            line.pop_back();
+        }
+        if (!line.empty() && line[0] != '#')
+        {
+            AddInputFiles(line, iFiles);
+        }
+    }
+    return true;
 }
 
 /**
@@ -201,8 +552,11 @@ int ParseArgs(int argc, char *argv[])
     if (argc < 2)
         return ShowHelp();
 
-    std::string in;
+    std::vector<std::string> in;
     std::string out;
+    std::string cacheFile;
+    RenderOptions options;
+    std::size_t jobs = option::Jobs::defValue;
     int i = 1;
     bool good = true;
     std::cout.precision(2);
@@ -236,7 +590,7 @@ int ParseArgs(int argc, char *argv[])
 
                 return 1;
             }
-            option::FileType::setFileType(argv[i + 1]);
+            options.fileType = argv[i + 1];
             i += 2;
         }
         else if ((std::string("-o") == argv[i] 
@@ -260,7 +614,7 @@ int ParseArgs(int argc, char *argv[])
                           <<"]\n";
                 return 1;
             }
-            option::NodeSep::setHSep(number);
+            options.nodeHSep = number;
             i += 2;
         }
         else if (std::string("--vns") == argv[i] && (i + 1) < argc)
@@ -277,7 +631,7 @@ int ParseArgs(int argc, char *argv[])
                           <<"]\n";
                 return 1;
             }
-            option::NodeSep::setVSep(number);
+            options.nodeVSep = number;
             i += 2;
         }
         else if (std::string("--pmw") == argv[i] && (i + 1) < argc)
@@ -294,7 +648,7 @@ int ParseArgs(int argc, char *argv[])
                           <<"]\n";
                 return 1;
             }
-            option::PageMargin::setPageMarginW(number);
+            options.pageMarginW = number;
             i += 2;
         }
         else if (std::string("--pmh") == argv[i] && (i + 1) < argc)
@@ -311,7 +665,7 @@ int ParseArgs(int argc, char *argv[])
                           <<"]\n";
                 return 1;
             }
-            option::PageMargin::setPageMarginH(number);
+            options.pageMarginH = number;
             i += 2;
         }
         else if (std::string("--fts") == argv[i] && (i + 1) < argc)
@@ -328,7 +682,81 @@ int ParseArgs(int argc, char *argv[])
                           <<"]\n";
                 return 1;
             }
-            option::FontSize::setFontSize(number);
+            options.fontSize = number;
+            i += 2;
+        }
+        else if (std::string("--tile") == argv[i] && (i + 1) < argc)
+        {
+            auto number = std::strtoull(argv[i + 1], nullptr, 10);
+            good = option::TileSize::isValid(number);
+            if (!good)
+            {
+                std::cout << "Invalid tile size"
+                          << ", it should be 0 or in range ["
+                          << option::TileSize::valueMin
+                          << ", "
+                          << option::TileSize::valueMax
+                          <<"]\n";
+                return 1;
+            }
+            options.tileSize = number;
+            i += 2;
+        }
+        else if (std::string("--scale") == argv[i] && (i + 1) < argc)
+        {
+            auto number = std::atof(argv[i + 1]);
+            good = option::Scale::isValid(number);
+            if (!good)
+            {
+                // The range is printed exactly, not with 2 fixed digits.
+                auto flags = std::cout.flags();
+                auto precision = std::cout.precision(6);
+                std::cout << std::defaultfloat
+                          << "Invalid output scale"
+                          << ", the valid value range is ["
+                          << option::Scale::valueMin
+                          << ", "
+                          << option::Scale::valueMax
+                          <<"]\n";
+                std::cout.flags(flags);
+                std::cout.precision(precision);
+                return 1;
+            }
+            options.scale = number;
+            i += 2;
+        }
+        else if (std::string("--lod") == argv[i] && (i + 1) < argc)
+        {
+            auto number = std::atof(argv[i + 1]);
+            good = option::LodSize::isValid(number);
+            if (!good)
+            {
+                std::cout << "Invalid level of detail label size"
+                          << ", the valid value range is ["
+                          << option::LodSize::valueMin
+                          << ", "
+                          << option::LodSize::valueMax
+                          <<"]\n";
+                return 1;
+            }
+            options.lodSize = number;
+            i += 2;
+        }
+        else if (std::string("--mtd") == argv[i] && (i + 1) < argc)
+        {
+            auto number = std::strtoull(argv[i + 1], nullptr, 10);
+            good = option::TreeDepth::isValid(number);
+            if (!good)
+            {
+                std::cout << "Invalid max tree depth"
+                          << ", the valid value range is ["
+                          << option::TreeDepth::valueMin
+                          << ", "
+                          << option::TreeDepth::valueMax
+                          <<"]\n";
+                return 1;
+            }
+            options.maxTreeDepth = number;
             i += 2;
         }
         else if (std::string("-h") == argv[i] 
@@ -341,9 +769,44 @@ int ParseArgs(int argc, char *argv[])
         {
             return ShowVersion();
         }
-        else if (argv[i][0] != '-' && in.empty())
+        else if ((std::string("-j") == argv[i] 
+                || std::string("--jobs") == argv[i]) 
+                && (i + 1) < argc)
+        {
+            auto number = std::strtoull(argv[i + 1], nullptr, 10);
+            good = option::Jobs::isValid(number);
+            if (!good)
+            {
+                std::cout << "Invalid job count"
+                          << ", the valid value range is ["
+                          << option::Jobs::valueMin
+                          << ", "
+                          << option::Jobs::valueMax()
+                          <<"]\n";
+                return 1;
+            }
+            jobs = number;
+            i += 2;
+        }
+        else if (std::string("--cache") == argv[i] && (i + 1) < argc)
+        {
+            cacheFile = argv[i + 1];
+            i += 2;
+        }
+        else if ((std::string("-l") == argv[i] 
+                || std::string("--list") == argv[i]) 
+                && (i + 1) < argc)
         {
-            in = argv[i];
+            if (!ReadManifest(argv[i + 1], in))
+            {
+                std::cout << "Cannot read file => " << argv[i + 1] << "\n";
+                return 1;
+            }
+            i += 2;
+        }
+        else if (argv[i][0] != '-')
+        {
+            AddInputFiles(argv[i], in);
             i += 1;
         }
         else
@@ -359,7 +822,57 @@ int ParseArgs(int argc, char *argv[])
         return 1;
     }
 
-    return DoWork(in, out);
+    if (in.size() > 1 && !out.empty())
+    {
+        std::cout << "The output file name can not be used with many input files.\n";
+        return 1;
+    }
+
+    // Tiles are drawn in full detail.
+    if (options.fileType == "png" && options.tileSize > 0 && options.lodSize > 0.0)
+    {
+        std::cout << "The level of detail can not be used with png tiles.\n";
+        return 1;
+    }
+
+    // A missing cache file is not an error, it is made at the end.
+    auto cache = std::make_shared<TextBoxCache>();
+    if (!cacheFile.empty() && std::ifstream(cacheFile) && !cache->load(cacheFile))
+    {
+        std::cout << "Invalid cache file => " << cacheFile << "\n";
+        return 1;
+    }
+
+    // The font is loaded once and shared, cairo contexts are only made for
+    // measuring if it fails.
+    auto metrics = std::make_shared<GlyphMetrics>(options);
+    if (!metrics->good())
+    {
+        metrics.reset();
+    }
+
+    int result = 0;
+    if (in.size() == 1)
+    {
+        result = DoWork(in.front(), out, options, cache, metrics, jobs);
+    }
+    else
+    {
+        result = DoBatchWork(in, options, jobs, cache, metrics);
+    }
+
+    if (in.size() > 1 || !cacheFile.empty())
+    {
+        ShowCacheStat(*cache);
+    }
+
+    if (!cacheFile.empty() && !cache->save(cacheFile))
+    {
+        std::cout << "Cannot write file => " << cacheFile << "\n";
+        return 1;
+    }
+
+    return result;
 }
 
 int main(int argc, char *argv[])
@@ -10,6 +10,8 @@
 #include "Lexer.h"
 
 #include <iostream>
+#include <sstream>
+#include <vector>
 
 using namespace cst;
 
@@ -36,8 +38,85 @@ int test_lexer()
     return ret;
 }
 
+int test_streaming_lexer()
+{
+    std::string text = R"--([S [NP abc] R"~~(x ) ]~" y)~~" [VP R"(cat and fish)" var123]])--";
+
+    auto collect = [](Lexer &lexer)
+    {
+        std::vector<std::string> tokens;
+        while (static_cast<int>(lexer.getNextTokenType()) > 0)
+        {
+            tokens.push_back(lexer.getCurrentToken());
+        }
+        tokens.push_back(std::to_string(static_cast<int>(lexer.getCurrentTokenType())));
+        tokens.push_back(std::to_string(lexer.getCursorOffset()));
+        return tokens;
+    };
+
+    Lexer lexer((uint8_t *)text.data(), text.size());
+    auto expected = collect(lexer);
+
+    // Tokens straddle the chunk boundaries.
+    for (std::size_t chunkSize = 1; chunkSize <= 16; ++chunkSize)
+    {
+        std::istringstream iss(text);
+        Lexer streamingLexer(iss, chunkSize);
+        if (collect(streamingLexer) != expected)
+        {
+            std::cout << "--streaming lexer fail, chunk size = " << chunkSize << std::endl;
+            return 1;
+        }
+    }
+
+    std::cout << "--streaming lexer ok" << std::endl;
+    return 0;
+}
+
+int test_cpp_raw_string()
+{
+    struct Case
+    {
+        std::string text;
+        std::string token;
+    } cases[] = {
+        {R"--(R"()")--", ""},
+        {R"--(R"ab(x)a)ab"])--", "x)a"},
+        {R"--(R"xy(1)x"2)y"3)xy"4)xy")--", "1)x\"2)y\"3"},
+        {R"--(R"aab(a)aa)aab"+)aab")--", "a)aa"},
+        {R"--(R"~(()))~(~)~")--", "()))~(~"},
+    };
+
+    for (auto &c : cases)
+    {
+        // Both the buffered and the byte by byte streaming lexer.
+        std::istringstream iss(c.text);
+        Lexer streamingLexer(iss, 1);
+        Lexer lexer((uint8_t *)c.text.data(), c.text.size());
+        for (auto pLexer : {&lexer, &streamingLexer})
+        {
+            if (pLexer->getNextTokenType() != Lexer::TokenType::CppRawString
+                || pLexer->getCurrentToken() != c.token)
+            {
+                std::cout << "--raw string fail: " << c.text << std::endl;
+                return 1;
+            }
+        }
+    }
+
+    std::string unterminated = R"--(R"ab(x)a"b)ab)--";
+    Lexer lexer((uint8_t *)unterminated.data(), unterminated.size());
+    if (lexer.getNextTokenType() != Lexer::TokenType::Error)
+    {
+        std::cout << "--raw string fail: " << unterminated << std::endl;
+        return 1;
+    }
+
+    std::cout << "--raw string ok" << std::endl;
+    return 0;
+}
 
 int main()
 {
-    return test_lexer();
+    return test_lexer() + test_streaming_lexer() + test_cpp_raw_string();
 }
\ No newline at end of file
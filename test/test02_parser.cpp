@@ -11,6 +11,8 @@
 #include "SyntaxTree.h"
 
 #include <iostream>
+#include <sstream>
+#include <vector>
 
 using namespace cst;
 
@@ -41,7 +43,228 @@ int test_parser()
     return 1;
 }
 
+int test_stream_parser()
+{
+    std::string treeStr = R"~([S [NP a] [VP [V b1] [V R"(cpp raw text)"]]] )~";
+
+    // A streamed tree has the same nodes as one parsed from a string.
+    std::istringstream iss(treeStr);
+    auto syntaxTree = Parser::buildSyntaxTree(treeStr);
+    auto streamedTree = Parser::buildSyntaxTree(iss);
+    if (!syntaxTree || !streamedTree || streamedTree->size() != syntaxTree->size())
+    {
+        return 1;
+    }
+
+    std::vector<Node *> stack{syntaxTree->getRoot()};
+    std::vector<Node *> streamedStack{streamedTree->getRoot()};
+    while (!stack.empty())
+    {
+        auto node = stack.back();
+        auto streamedNode = streamedStack.back();
+        stack.pop_back();
+        streamedStack.pop_back();
+        if (node->label() != streamedNode->label()
+            || node->childArray().size() != streamedNode->childArray().size())
+        {
+            return 1;
+        }
+        stack.insert(stack.end(), node->childArray().begin(), node->childArray().end());
+        streamedStack.insert(streamedStack.end(), streamedNode->childArray().begin(), streamedNode->childArray().end());
+    }
+
+    // An empty stream has no tree and no error, white space is an error.
+    std::ostringstream errors;
+    auto cerrBuf = std::cerr.rdbuf(errors.rdbuf());
+    std::istringstream empty;
+    auto emptyTree = Parser::buildSyntaxTree(empty);
+    auto emptyErrors = errors.str();
+    std::istringstream blank(" \n\t");
+    auto blankTree = Parser::buildSyntaxTree(blank);
+    std::cerr.rdbuf(cerrBuf);
+    if (emptyTree || !emptyErrors.empty() || blankTree || errors.str().empty())
+    {
+        return 1;
+    }
+
+    std::cout << "--stream parser is ok." << std::endl;
+    return 0;
+}
+
+int test_deep_tree()
+{
+    // Far deeper than a recursive parser could go on a default stack.
+    const std::size_t depth = 300000;
+
+    std::string treeStr;
+    for (std::size_t i = 0; i < depth; ++i)
+    {
+        treeStr += "[a ";
+    }
+    treeStr += std::string(depth, ']');
+
+    auto syntaxTree = Parser::buildSyntaxTree(treeStr);
+    if (!syntaxTree)
+    {
+        return 1;
+    }
+
+    std::size_t count = 0;
+    for (auto node = syntaxTree->getRoot(); node; node = node->leftMostChild())
+    {
+        ++count;
+    }
+    if (count != depth)
+    {
+        return 1;
+    }
+
+    // One level too deep, it is an error instead of a stack overflow.
+    if (Parser::buildSyntaxTree(treeStr, depth - 1))
+    {
+        return 1;
+    }
+
+    std::cout << "--parser deep tree is ok." << std::endl;
+    return 0;
+}
+
+int test_node_id()
+{
+    std::string treeStr = "[S [NP a] [VP [V b] c]]";
+
+    // Every tree numbers its own nodes, in preorder.
+    for (int i = 0; i < 2; ++i)
+    {
+        auto syntaxTree = Parser::buildSyntaxTree(treeStr);
+        if (!syntaxTree || syntaxTree->size() != 7)
+        {
+            return 1;
+        }
+
+        std::vector<Node *> stack{syntaxTree->getRoot()};
+        std::size_t nextId = 0;
+        while (!stack.empty())
+        {
+            auto node = stack.back();
+            stack.pop_back();
+            if (node->id() != nextId++)
+            {
+                return 1;
+            }
+            auto &childArray = node->childArray();
+            stack.insert(stack.end(), childArray.rbegin(), childArray.rend());
+        }
+    }
+
+    // An adopted tree is numbered too.
+    SyntaxTree tree(new Node("a", {new Node("b", {new Node("c")}), new Node("d")}));
+    if (tree.size() != 4 || tree.getRoot()->rightMostChild()->id() != 3)
+    {
+        return 1;
+    }
+
+    std::cout << "--node id is ok." << std::endl;
+    return 0;
+}
+
+int test_raw_string_label()
+{
+    auto syntaxTree = Parser::buildSyntaxTree(R"~([S R"(label = "a")" R"(color = "red")"])~");
+    if (!syntaxTree)
+    {
+        return 1;
+    }
+
+    // The label comes from the property, a property without a label gets
+    // an empty one and the node gets the default label.
+    auto &children = syntaxTree->getRoot()->childArray();
+    if (children.size() != 2 
+        || children[0]->label() != "a"
+        || children[1]->label() != option::defEmptyLabel
+        || children[1]->property().count("label") != 1
+        || !children[1]->property().at("label").empty())
+    {
+        return 1;
+    }
+
+    std::cout << "--raw string label is ok." << std::endl;
+    return 0;
+}
+
+int test_tree_reader()
+{
+    std::string corpus = "[S [NP a] [VP b]]\n[X y]\n\n[A [B [C d]]]\n";
+    const char *roots[] = {"S", "X", "A"};
+    const std::size_t sizes[] = {5, 2, 4};
+
+    // In-memory and streamed input give the same trees.
+    for (int pass = 0; pass < 2; ++pass)
+    {
+        std::istringstream iss(corpus);
+        std::unique_ptr<TreeReader> reader;
+        if (pass == 0)
+            reader.reset(new TreeReader((const uint8_t *)corpus.data(), corpus.size()));
+        else
+            reader.reset(new TreeReader(iss));
+
+        std::size_t i = 0;
+        for (auto &tree : *reader)
+        {
+            if (i >= 3 || tree->getRoot()->label() != roots[i] || tree->size() != sizes[i])
+            {
+                return 1;
+            }
+            ++i;
+        }
+        if (i != 3 || reader->count() != 3 || !reader->good() || reader->next())
+        {
+            return 1;
+        }
+    }
+
+    // The trees before an error are still returned.
+    std::string bad = "[a][b [c]] c]";
+    TreeReader reader((const uint8_t *)bad.data(), bad.size());
+    if (!reader.next() || !reader.next() || reader.next() || reader.good() || reader.count() != 2)
+    {
+        return 1;
+    }
+
+    // A single tree parser still rejects trailing trees.
+    if (Parser::buildSyntaxTree(corpus))
+    {
+        return 1;
+    }
+
+    // White space without a tree is a parse error, an empty input is not.
+    std::string blank = " \n\t\n";
+    std::istringstream blankStream(blank), emptyStream;
+    TreeReader blankReader((const uint8_t *)blank.data(), blank.size());
+    TreeReader blankStreamReader(blankStream);
+    TreeReader emptyReader(emptyStream);
+    if (Parser::buildSyntaxTree(blank) 
+        || blankReader.next() || blankReader.good()
+        || blankStreamReader.next() || blankStreamReader.good()
+        || emptyReader.next() || !emptyReader.good())
+    {
+        return 1;
+    }
+
+    std::cout << "--tree reader is ok." << std::endl;
+    return 0;
+}
+
 int main()
 {
-    return test_parser();
+    int i = 0;
+
+    i += test_parser();
+    i += test_stream_parser();
+    i += test_deep_tree();
+    i += test_node_id();
+    i += test_tree_reader();
+    i += test_raw_string_label();
+
+    return i;
 }
\ No newline at end of file
@@ -8,9 +8,11 @@
  */
 
 #include "Layouter.h"
+#include "FlatTree.h"
 #include "SyntaxTree.h"
 
 #include <iostream>
+#include <random>
 #include <string>
 
 using namespace cst;
@@ -77,12 +79,338 @@ int test2()
     return work(t);
 }
 
+int test3()
+{
+    // A chain far deeper than a recursive walk could go on a default stack.
+    const std::size_t depth = 300000;
+
+    auto t = new Node("a");
+    auto leaf = t;
+    for (std::size_t i = 1; i < depth; ++i)
+    {
+        auto child = new Node("a");
+        leaf->append(child);
+        leaf = child;
+    }
+
+    SyntaxTree tree(t);
+    TreeSize treeSize;
+    Layouter layouter;
+
+    std::cout << "==[test3]============================================\n";
+    if (layouter.layout(tree.getRoot(), treeSize)
+        && leaf->x() == t->x()
+        && treeSize.ymax == (depth - 1) * option::NodeSep::defVSep)
+    {
+        std::cout << "deep tree height = " << treeSize.ymax << std::endl;
+        return 0;
+    }
+
+    return 1;
+}
+
+int test4()
+{
+    auto t = new Node("a",{ new Node("b",{ new Node("e"), new Node("f"), new Node("g") }),
+                            new Node("c"),
+                            new Node("d",{ new Node("h",{ new Node("i"), new Node("j") }) })
+                          });
+    SyntaxTree tree(t);
+    TreeSize treeSize;
+    Layouter layouter;
+    if (!layouter.layout(t, treeSize))
+    {
+        return 1;
+    }
+
+    // The same tree built by index, in preorder.
+    FlatTree flat;
+    auto a = flat.add(FlatTree::nil, t->textBox().width);
+    auto b = flat.add(a);
+    flat.add(b);
+    flat.add(b);
+    flat.add(b);
+    flat.add(a);
+    auto d = flat.add(a);
+    auto h = flat.add(d);
+    flat.add(h);
+    flat.add(h);
+
+    TreeSize flatSize;
+    if (!layouter.layout(flat, flatSize) || flat.size() != 10
+        || flat.number[d] != 2 || flat.number[h] != 0 || flat.number[flat.lastChild[b]] != 2)
+    {
+        return 1;
+    }
+
+    FlatTree copy(t);
+    std::cout << "==[test4]============================================\n";
+    for (std::size_t i = 0; i < flat.size(); ++i)
+    {
+        std::cout << copy.node[i]->label() << "[x=" << flat.x[i] << ", y=" << flat.y[i] << "]\n";
+        if (flat.x[i] != copy.node[i]->x() || flat.y[i] != copy.node[i]->y())
+        {
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+int test5()
+{
+    // Long labels under different parents meet in the contour walk.
+    auto t = new Node("S",{ new Node("NP",{ new Node("a_very_long_label"), new Node("b") }),
+                            new Node("VP",{ new Node("another_long_label"), 
+                                            new Node("PP",{ new Node("x"), new Node("yet_another_long_one") }) }),
+                            new Node("c")
+                          });
+    SyntaxTree tree(t);
+    TreeSize treeSize;
+    RenderOptions options;
+    Layouter layouter(options);
+    if (!layouter.layout(t, treeSize))
+    {
+        return 1;
+    }
+
+    // On every level the labels keep half a font size apart, and short
+    // labels stay nodeHSep apart.
+    FlatTree flat(t);
+    std::cout << "==[test5]============================================\n";
+    for (std::size_t i = 0; i < flat.size(); ++i)
+    {
+        auto u = flat.node[i];
+        std::cout << u->label() << "[x=" << u->x() << ", y=" << u->y() << "]\n";
+        for (std::size_t j = 0; j < flat.size(); ++j)
+        {
+            auto v = flat.node[j];
+            if (i == j || flat.depth[i] != flat.depth[j] || u->x() > v->x())
+            {
+                continue;
+            }
+            auto gap = (v->x() - u->x()) - (u->textBox().width + v->textBox().width) * 0.5;
+            if (gap < options.fontSize * 0.5 - 1e-9 || v->x() - u->x() < options.nodeHSep - 1e-9)
+            {
+                std::cout << u->label() << " and " << v->label() << " overlap." << std::endl;
+                return 1;
+            }
+        }
+    }
+
+    return 0;
+}
+
+int test6()
+{
+    // Edit a random tree one label or subtree at a time, relayout() must
+    // agree with a full layout after every edit.
+    std::mt19937 random(19);
+    auto randomWidth = [&]() { return static_cast<double>(random() % 200); };
+
+    FlatTree t;
+    t.add(FlatTree::nil, randomWidth());
+    for (int i = 1; i < 2000; ++i)
+    {
+        t.add(random() % t.size(), randomWidth());
+    }
+
+    Layouter layouter;
+    TreeSize treeSize;
+    if (!layouter.relayout(t, FlatTree::nil, treeSize) || layouter.touched() != t.size())
+    {
+        return 1;
+    }
+
+    std::size_t touched = 0;
+    std::cout << "==[test6]============================================\n";
+    for (int edit = 0; edit < 100; ++edit)
+    {
+        auto changed = FlatTree::nil;
+        if (edit % 2 == 0)
+        {
+            changed = random() % t.size();
+            t.width[changed] = randomWidth();
+        }
+        else
+        {
+            auto p = t.add(random() % t.size(), randomWidth());
+            t.add(p, randomWidth());
+            t.add(p, randomWidth());
+        }
+
+        if (!layouter.relayout(t, changed, treeSize))
+        {
+            return 1;
+        }
+        touched += layouter.touched();
+
+        FlatTree full(t);
+        TreeSize fullSize;
+        if (!layouter.layout(full, fullSize)
+            || fullSize.xmin != treeSize.xmin || fullSize.xmax != treeSize.xmax
+            || fullSize.ymax != treeSize.ymax)
+        {
+            return 1;
+        }
+        for (std::size_t i = 0; i < t.size(); ++i)
+        {
+            if (t.x[i] != full.x[i] || t.y[i] != full.y[i])
+            {
+                std::cout << "edit " << edit << ": node " << i << " differs." << std::endl;
+                return 1;
+            }
+        }
+    }
+    std::cout << t.size() << " nodes, " << touched / 100 << " nodes touched per edit.\n";
+
+    // The undo state belongs to one tree, another tree starts over and so
+    // does the first one after it.
+    FlatTree other;
+    other.add(other.add(FlatTree::nil, 10.0), 20.0);
+    if (!layouter.relayout(other, FlatTree::nil, treeSize) || layouter.touched() != other.size()
+        || !layouter.relayout(t, FlatTree::nil, treeSize) || layouter.touched() != t.size())
+    {
+        return 1;
+    }
+
+    return touched / 100 < t.size() / 4 ? 0 : 1;
+}
+
+int test7()
+{
+    // A label is edited, remeasure() sets its width for relayout().
+    auto t = new Node("S",{ new Node("NP",{ new Node("a"), new Node("b") }),
+                            new Node("VP",{ new Node("c"), new Node("d") })
+                          });
+    SyntaxTree tree(t);
+    FlatTree flat(t);
+    TreeSize treeSize;
+    Layouter layouter;
+    if (!layouter.measure(flat) || !layouter.relayout(flat, FlatTree::nil, treeSize))
+    {
+        return 1;
+    }
+
+    FlatTree::Index c = 5;
+    auto width = flat.width[c];
+    flat.node[c]->label("a_much_longer_label");
+    if (!layouter.remeasure(flat, c) || flat.width[c] <= width
+        || flat.width[c] != flat.node[c]->textBox().width
+        || !layouter.relayout(flat, c, treeSize))
+    {
+        return 1;
+    }
+
+    FlatTree full(t);
+    TreeSize fullSize;
+    if (!layouter.measure(full) || !layouter.layout(full, fullSize) 
+        || fullSize.xmin != treeSize.xmin || fullSize.xmax != treeSize.xmax)
+    {
+        return 1;
+    }
+    for (std::size_t i = 0; i < flat.size(); ++i)
+    {
+        if (flat.x[i] != full.x[i] || flat.y[i] != full.y[i])
+        {
+            return 1;
+        }
+    }
+
+    // A tree built by index has no labels, and there is no node 7.
+    FlatTree byIndex;
+    byIndex.add(FlatTree::nil, 10.0);
+    if (layouter.remeasure(byIndex, 0) || layouter.remeasure(flat, 7))
+    {
+        return 1;
+    }
+
+    std::cout << "==[test7]============================================\n";
+    std::cout << "remeasure pass." << std::endl;
+    return 0;
+}
+
+int test8()
+{
+    // A tree refilled in place is a new tree to relayout(), the undo state
+    // of its old content is not replayed on it.
+    std::mt19937 random(23);
+    auto fill = [&](FlatTree& t, int count)
+    {
+        t.add(FlatTree::nil, static_cast<double>(random() % 200));
+        for (int i = 1; i < count; ++i)
+        {
+            t.add(random() % t.size(), static_cast<double>(random() % 200));
+        }
+    };
+
+    auto t = new Node("S",{ new Node("NP",{ new Node("a"), new Node("b") }),
+                            new Node("VP",{ new Node("c") })
+                          });
+    SyntaxTree tree(t);
+
+    FlatTree flat;
+    fill(flat, 500);
+    Layouter layouter;
+    TreeSize treeSize;
+    for (int refill = 0; refill < 2; ++refill)
+    {
+        if (!layouter.relayout(flat, FlatTree::nil, treeSize))
+        {
+            return 1;
+        }
+
+        if (refill == 0)
+        {
+            flat.clear();
+            fill(flat, 600);
+        }
+        else
+        {
+            auto generation = flat.generation();
+            flat.assign(t);
+            if (flat.generation() == generation)
+            {
+                return 1;
+            }
+        }
+
+        if (!layouter.relayout(flat, FlatTree::nil, treeSize) || layouter.touched() != flat.size())
+        {
+            return 1;
+        }
+        FlatTree full(flat);
+        TreeSize fullSize;
+        if (!layouter.layout(full, fullSize))
+        {
+            return 1;
+        }
+        for (std::size_t i = 0; i < flat.size(); ++i)
+        {
+            if (flat.x[i] != full.x[i] || flat.y[i] != full.y[i])
+            {
+                return 1;
+            }
+        }
+    }
+
+    std::cout << "==[test8]============================================\n";
+    std::cout << "relayout of a refilled tree pass." << std::endl;
+    return 0;
+}
+
 int main()
 {
     int i = 0;
 
     i += test1();
     i += test2();
+    i += test3();
+    i += test4();
+    i += test5();
+    i += test6();
+    i += test7();
+    i += test8();
 
     return i;
 }
\ No newline at end of file
@@ -12,7 +12,11 @@
 #include "Boxy.h"
 #include "Layouter.h"
 
+#include <cmath>
+#include <cstdio>
+#include <fstream>
 #include <iostream>
+#include <string>
 
 using namespace cst;
 
@@ -97,7 +101,278 @@ int test_renderer()
     return 1;
 }
 
+int test_pdf_book()
+{
+    std::string corpus = "[S [NP a] [VP b]] [X y] [A [B [C d]] [E f]]";
+    TreeReader reader((const uint8_t *)corpus.data(), corpus.size());
+
+    // One pdf context holds a page per tree.
+    RenderOptions options;
+    auto book = Renderer::createBook("test_book.pdf", options);
+    if (!book)
+    {
+        return 1;
+    }
+
+    Layouter layouter(options);
+    for (auto &tree : reader)
+    {
+        TreeSize treeSize;
+        if (!layouter.layout(tree->getRoot(), treeSize))
+        {
+            return 1;
+        }
+        Renderer renderer(tree, treeSize, book, options);
+        if (!renderer.drawTree())
+        {
+            return 1;
+        }
+    }
+    book.reset();
+
+    if (reader.count() != 3 || !std::ifstream("test_book.pdf"))
+    {
+        return 1;
+    }
+
+    // A shared renderer needs a context.
+    auto tree = Parser::buildSyntaxTree("[a]");
+    TreeSize treeSize;
+    layouter.layout(tree->getRoot(), treeSize);
+    if (Renderer(tree, treeSize, CairoContextPtr(), options).drawTree())
+    {
+        return 1;
+    }
+    std::remove("test_book.pdf");
+
+    std::cout << "draw pdf book pass." << std::endl;
+    return 0;
+}
+
+int test_tiles()
+{
+    // Too wide for one cairo image, it is split into tiles automatically.
+    std::string buf = "[S";
+    for (int i = 0; i < 2000; ++i)
+    {
+        buf += " [w]";
+    }
+    buf += "]";
+
+    RenderOptions options;
+    options.fileType = "png";
+    for (std::size_t tileSize : {std::size_t(0), std::size_t(256)})
+    {
+        auto tree = Parser::buildSyntaxTree(buf);
+        TreeSize treeSize;
+        Layouter layouter(options);
+        if (!tree || !layouter.layout(tree->getRoot(), treeSize))
+        {
+            return 1;
+        }
+
+        options.tileSize = tileSize;
+        Renderer renderer(tree, treeSize, "test_tiles.png", options);
+        if (!renderer.drawTree())
+        {
+            return 1;
+        }
+
+        auto width = std::ceil(options.pageMarginW * 2.0 + treeSize.xmax - treeSize.xmin);
+        auto height = std::ceil(options.pageMarginH * 2.0 + treeSize.ymax);
+        auto size = tileSize == 0 ? 4096.0 : static_cast<double>(tileSize);
+        auto rows = static_cast<std::size_t>(std::ceil(height / size));
+        auto cols = static_cast<std::size_t>(std::ceil(width / size));
+        if (width <= 32767.0 || renderer.tileCount() != rows * cols)
+        {
+            return 1;
+        }
+
+        for (std::size_t row = 0; row < rows; ++row)
+        {
+            for (std::size_t col = 0; col < cols; ++col)
+            {
+                auto name = Renderer::tileFileName("test_tiles.png", row, col);
+                if (!std::ifstream(name))
+                {
+                    std::cout << "missing tile " << name << std::endl;
+                    return 1;
+                }
+                std::remove(name.c_str());
+            }
+        }
+    }
+
+    if (Renderer::tileFileName("a.txt.png", 0, 12) != "a.txt.r0.c12.png"
+        || Renderer::tileFileName("dir.x/a", 1, 2) != "dir.x/a.r1.c2")
+    {
+        return 1;
+    }
+
+    std::cout << "draw png tiles pass." << std::endl;
+    return 0;
+}
+
+int test_edge_and_color_groups()
+{
+    // More edges than one stroked path holds, the labels are red or of
+    // the default color. The page is scaled to stay in one image.
+    std::string buf = "[ROOT";
+    for (int i = 0; i < 2000; ++i)
+    {
+        buf += R"~( [S [R"(label = "while" color = "red")"] [NP a] [VP [V b] [N c]]])~";
+    }
+    buf += "]";
+
+    RenderOptions options;
+    options.fileType = "png";
+    options.scale = 0.1;
+    auto tree = Parser::buildSyntaxTree(buf);
+    TreeSize treeSize;
+    Layouter layouter(options);
+    if (!tree || !layouter.layout(tree->getRoot(), treeSize))
+    {
+        return 1;
+    }
+
+    std::size_t nodeCount = 0;
+    NodeArray stack{tree->getRoot()};
+    while (!stack.empty())
+    {
+        auto n = stack.back();
+        stack.pop_back();
+        ++nodeCount;
+        stack.insert(stack.end(), n->childArray().begin(), n->childArray().end());
+    }
+
+    Renderer renderer(tree, treeSize, "test_groups.png", options);
+    auto ok = renderer.drawTree();
+    auto &stats = renderer.drawStats();
+    if (!ok || stats.edges != nodeCount - 1 || stats.edges <= Renderer::edgeBatch || stats.strokes < 2
+        || stats.labels != nodeCount || stats.colorGroups != 2)
+    {
+        std::cout << "edges " << stats.edges << ", strokes " << stats.strokes
+                  << ", labels " << stats.labels << ", groups " << stats.colorGroups << std::endl;
+        return 1;
+    }
+    std::remove("test_groups.png");
+
+    std::cout << "draw edge and color groups pass." << std::endl;
+    return 0;
+}
+
+int test_lod()
+{
+    // A thumbnail of a tree too wide for one image, in less detail.
+    std::string buf = "[S";
+    for (int i = 0; i < 2000; ++i)
+    {
+        buf += " [NP [D the] [N w" + std::to_string(i) + "]]";
+    }
+    buf += "]";
+
+    RenderOptions options;
+    options.scale = 0.01;
+    options.lodSize = 4.0;
+    if (!options.isValid())
+    {
+        return 1;
+    }
+
+    for (auto fileType : {"png", "svg", "pdf"})
+    {
+        options.fileType = fileType;
+        auto tree = Parser::buildSyntaxTree(buf);
+        TreeSize treeSize;
+        Layouter layouter(options);
+        if (!tree || !layouter.layout(tree->getRoot(), treeSize))
+        {
+            return 1;
+        }
+
+        // The file is complete when the renderer is gone.
+        auto fileName = std::string("test_lod.") + fileType;
+        {
+            Renderer renderer(tree, treeSize, fileName, options);
+            if (!renderer.drawTree() || renderer.tileCount() != 0)
+            {
+                return 1;
+            }
+        }
+        if (!std::ifstream(fileName))
+        {
+            std::cout << "missing " << fileName << std::endl;
+            return 1;
+        }
+        std::remove(fileName.c_str());
+    }
+
+    // Less detail than the full page of the same size. A tiny page has
+    // collapsed subtrees and merged edges, a larger one has boxes for the
+    // labels.
+    for (auto scale : {0.01, 0.2})
+    {
+        auto tree = Parser::buildSyntaxTree(buf);
+        TreeSize treeSize;
+        Layouter layouter(options);
+        if (!tree || !layouter.layout(tree->getRoot(), treeSize))
+        {
+            return 1;
+        }
+
+        DrawStats stats[2];
+        options.fileType = "png";
+        options.scale = scale;
+        for (auto lod : {0, 1})
+        {
+            options.lodSize = lod ? 4.0 : 0.0;
+            Renderer renderer(tree, treeSize, "test_lod.png", options);
+            if (!renderer.drawTree())
+            {
+                return 1;
+            }
+            stats[lod] = renderer.drawStats();
+        }
+        std::remove("test_lod.png");
+
+        auto &full = stats[0];
+        auto &lod = stats[1];
+        if (full.boxes != 0 || full.triangles != 0 || lod.labels >= full.labels || lod.strokes != 1
+            || (scale == 0.01 && (lod.triangles == 0 || lod.edges >= full.edges))
+            || (scale == 0.2 && (lod.boxes == 0 || lod.edges != full.edges)))
+        {
+            std::cout << "scale " << scale << ", full " << full.edges << " edges " << full.labels << " labels"
+                      << ", lod " << lod.edges << " edges " << lod.labels << " labels "
+                      << lod.boxes << " boxes " << lod.triangles << " triangles" << std::endl;
+            return 1;
+        }
+    }
+
+    options.scale = 0.0;
+    if (options.isValid())
+    {
+        return 1;
+    }
+    options.scale = 1.0;
+    options.lodSize = -1.0;
+    if (options.isValid())
+    {
+        return 1;
+    }
+
+    std::cout << "draw level of detail pass." << std::endl;
+    return 0;
+}
+
 int main()
 {
-    return test_renderer();
+    int i = 0;
+
+    i += test_renderer();
+    i += test_pdf_book();
+    i += test_tiles();
+    i += test_edge_and_color_groups();
+    i += test_lod();
+
+    return i;
 }
\ No newline at end of file
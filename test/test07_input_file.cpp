@@ -0,0 +1,70 @@
+/**
+ * The MIT License
+ *
+ * Copyright 2022 Krishna sssky307@163.com
+ *
+ * For the full copyright and license information, please view the LICENSE
+ * file that was distributed with this source code.
+ */
+
+#include "InputFile.h"
+#include "Parser.h"
+#include "SyntaxTree.h"
+
+#include <iostream>
+#include <fstream>
+#include <cstdio>
+#include <cstring>
+
+using namespace cst;
+
+int test_input_file()
+{
+    std::string fileName = "test07_input_file.txt";
+    std::string treeStr = "[S [NP a] [VP [V b] R\"(label = \"c\")\"]]";
+    {
+        std::ofstream ofs(fileName, std::ios::binary);
+        ofs << treeStr;
+    }
+
+    int ret = 1;
+    if (!InputFile::isRegularFile(fileName) || InputFile::isRegularFile("."))
+    {
+        std::cout << "--input file test fail" << std::endl;
+        std::remove(fileName.c_str());
+        return 1;
+    }
+
+    {
+        InputFile input(fileName);
+        if (input.good() 
+            && input.size() == treeStr.size()
+            && std::memcmp(input.data(), treeStr.data(), treeStr.size()) == 0)
+        {
+            std::cout << "mapped = " << (input.isMapped() ? "yes" : "no") << std::endl;
+
+            auto syntaxTree = Parser::buildSyntaxTree(input.data(), input.size());
+            if (syntaxTree)
+            {
+                syntaxTree->dumpTree();
+                ret = 0;
+            }
+        }
+    }
+
+    std::remove(fileName.c_str());
+
+    InputFile missing("test07_input_file.missing");
+    if (missing.good() || InputFile::isRegularFile("test07_input_file.missing"))
+    {
+        ret = 1;
+    }
+
+    std::cout << "--input file test " << ((ret == 0) ? ("pass") : ("fail")) << std::endl;
+    return ret;
+}
+
+int main()
+{
+    return test_input_file();
+}
@@ -0,0 +1,117 @@
+/**
+ * The MIT License
+ *
+ * Copyright 2022 Krishna sssky307@163.com
+ *
+ * For the full copyright and license information, please view the LICENSE
+ * file that was distributed with this source code.
+ */
+
+#include "CharScanner.h"
+#include "Lexer.h"
+
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace cst;
+
+using Level = CharScanner::Level;
+
+std::vector<Level> supportedLevels()
+{
+    std::vector<Level> levels;
+    for (auto level : {Level::Scalar, Level::SSE2, Level::AVX2})
+    {
+        if (static_cast<int>(level) <= static_cast<int>(CharScanner::bestLevel()))
+        {
+            levels.push_back(level);
+        }
+    }
+    return levels;
+}
+
+int test_scan_functions()
+{
+    // Runs of every character class, including all 256 byte values.
+    std::mt19937 rng(20220501);
+    std::string pieces[] = {" ", "\t\r\n\f", "\v", "abcDEF012", "[", "]", ")", "\"", "\x7f", "\xa0\xfd", "\xfe\xff", "\x80\x9f"};
+    std::vector<uint8_t> buf;
+    for (int i = 0; i < 256; ++i)
+    {
+        buf.push_back(static_cast<uint8_t>(i));
+    }
+    while (buf.size() < 4096)
+    {
+        auto &piece = pieces[rng() % (sizeof(pieces) / sizeof(pieces[0]))];
+        auto repeat = rng() % 40;
+        for (std::size_t i = 0; i < repeat; ++i)
+        {
+            buf.insert(buf.end(), piece.begin(), piece.end());
+        }
+    }
+
+    CharScanner scalar(Level::Scalar);
+    for (auto level : supportedLevels())
+    {
+        CharScanner scanner(level);
+        auto end = buf.data() + buf.size();
+        for (auto p = buf.data(); p <= end; ++p)
+        {
+            // A few ends to cover the tail handling.
+            for (auto q : {end, p + (end - p) / 2, p + (end - p) / 3})
+            {
+                if (scanner.skipSpace(p, q) != scalar.skipSpace(p, q)
+                    || scanner.skipLabel(p, q) != scalar.skipLabel(p, q)
+                    || scanner.findRawStop(p, q) != scalar.findRawStop(p, q))
+                {
+                    std::cout << "scan mismatch, level = " << CharScanner::levelName(level)
+                              << ", offset = " << (p - buf.data()) << std::endl;
+                    return 1;
+                }
+            }
+        }
+        std::cout << "scan functions ok, level = " << CharScanner::levelName(level) << std::endl;
+    }
+
+    return 0;
+}
+
+int test_lexer_levels()
+{
+    std::string text = R"--([S [NP a_long_label_with_more_than_32_characters_in_it]
+        [VP R"~~(raw ) text " with )~ stops)~~"     [V b]]
+        label_at_the_end_of_the_buffer_longer_than_32])--";
+
+    auto collect = [&](Level level)
+    {
+        Lexer lexer((const uint8_t *)text.data(), text.size(), level);
+        std::vector<std::string> tokens;
+        while (static_cast<int>(lexer.getNextTokenType()) > 0)
+        {
+            tokens.push_back(lexer.getCurrentToken());
+        }
+        tokens.push_back(std::to_string(static_cast<int>(lexer.getCurrentTokenType())));
+        return tokens;
+    };
+
+    auto expected = collect(Level::Scalar);
+    for (auto level : supportedLevels())
+    {
+        if (collect(level) != expected)
+        {
+            std::cout << "lexer mismatch, level = " << CharScanner::levelName(level) << std::endl;
+            return 1;
+        }
+    }
+
+    std::cout << "lexer levels ok, best level = " 
+              << CharScanner::levelName(CharScanner::bestLevel()) << std::endl;
+    return 0;
+}
+
+int main()
+{
+    return test_scan_functions() + test_lexer_levels();
+}
@@ -0,0 +1,172 @@
+/**
+ * The MIT License
+ *
+ * Copyright 2022 Krishna sssky307@163.com
+ *
+ * For the full copyright and license information, please view the LICENSE
+ * file that was distributed with this source code.
+ */
+
+#include "Arena.h"
+#include "Parser.h"
+#include "SyntaxTree.h"
+
+#include <iostream>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+using namespace cst;
+
+int test_arena()
+{
+    int destroyed = 0;
+    struct Counter
+    {
+        Counter(int* count) : count(count) {}
+        ~Counter() { ++*count; }
+        int* count;
+    };
+
+    {
+        Arena arena(256);
+        for (std::size_t align : {1, 2, 8, 16, 64})
+        {
+            auto p = arena.allocate(3, align);
+            if (reinterpret_cast<std::uintptr_t>(p) % align != 0)
+            {
+                return 1;
+            }
+        }
+
+        // Larger than a block.
+        auto big = static_cast<char*>(arena.allocate(10000));
+        big[0] = big[9999] = 'x';
+
+        std::vector<int, ArenaAllocator<int>> v{ArenaAllocator<int>(&arena)};
+        for (int i = 0; i < 1000; ++i)
+        {
+            v.push_back(i);
+        }
+        if (v[999] != 999)
+        {
+            return 1;
+        }
+
+        arena.make<Counter>(&destroyed);
+        arena.make<Counter>(&destroyed);
+        if (destroyed != 0)
+        {
+            return 1;
+        }
+    }
+
+    if (destroyed != 2)
+    {
+        return 1;
+    }
+
+    std::cout << "--arena is ok." << std::endl;
+    return 0;
+}
+
+int test_arena_unaligned_end()
+{
+    // Count the bytes which fit in a block of 100, it is not a multiple of 8.
+    int fit = 0;
+    {
+        Arena arena(100);
+        while (arena.allocate(1, 1), arena.blockCount() < 2)
+        {
+            ++fit;
+        }
+    }
+
+    // Fill another one to its odd end, aligning the cursor steps past it.
+    Arena arena(100);
+    auto first = static_cast<char*>(arena.allocate(1, 1));
+    for (int i = 1; i < fit; ++i)
+    {
+        arena.allocate(1, 1);
+    }
+    auto p = static_cast<char*>(arena.allocate(8, 8));
+    if (arena.blockCount() != 2
+        || reinterpret_cast<std::uintptr_t>(p) % 8 != 0
+        || (p >= first && p < first + 100))
+    {
+        return 1;
+    }
+
+    std::cout << "--arena unaligned end is ok." << std::endl;
+    return 0;
+}
+
+int test_tree_arena()
+{
+    std::string treeStr = R"~([S [NP a] [VP [V b] R"(label = "a long label which is not in the small string buffer")"]])~";
+
+    auto syntaxTree = Parser::buildSyntaxTree(treeStr);
+    if (!syntaxTree)
+    {
+        return 1;
+    }
+
+    auto root = syntaxTree->getRoot();
+    if (root->arena() != &syntaxTree->arena()
+        || root->rightMostChild()->rightMostChild()->arena() != &syntaxTree->arena()
+        || syntaxTree->arena().blockCount() != 1)
+    {
+        return 1;
+    }
+
+    auto raw = root->rightMostChild()->rightMostChild();
+    if (raw->label() != "a long label which is not in the small string buffer"
+        || raw->property().at("label") != raw->label().c_str())
+    {
+        return 1;
+    }
+
+    // A root from the arena of another tree is not adopted.
+    SyntaxTree other;
+    auto heapRoot = new Node("H");
+    if (other.setRoot(root) || other.getRoot() != nullptr 
+        || !other.setRoot(heapRoot) || other.setRoot(root) || other.getRoot() != heapRoot
+        || !other.setRoot(other.newNode("N")))
+    {
+        return 1;
+    }
+
+    // A null root leaves an empty tree.
+    if (!other.setRoot(nullptr) || other.size() != 0)
+    {
+        return 1;
+    }
+
+    // Own nodes are numbered in preorder, also a parent made after its
+    // children and a subtree.
+    auto a = other.newNode("A");
+    auto b = other.newNode("B");
+    auto p = other.newNode("P");
+    p->append(a);
+    p->append(b);
+    if (!other.setRoot(p) || other.size() != 3 || p->id() != 0 || a->id() != 1 || b->id() != 2
+        || !other.setRoot(b) || other.size() != 1 || b->id() != 0)
+    {
+        return 1;
+    }
+
+    syntaxTree->dumpTree();
+    std::cout << "--tree arena is ok." << std::endl;
+    return 0;
+}
+
+int main()
+{
+    int i = 0;
+
+    i += test_arena();
+    i += test_arena_unaligned_end();
+    i += test_tree_arena();
+
+    return i;
+}
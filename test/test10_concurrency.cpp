@@ -0,0 +1,194 @@
+/**
+ * The MIT License
+ *
+ * Copyright 2022 Krishna sssky307@163.com
+ *
+ * For the full copyright and license information, please view the LICENSE
+ * file that was distributed with this source code.
+ */
+
+#include "Parser.h"
+#include "Layouter.h"
+#include "Renderer.h"
+#include "SyntaxTree.h"
+#include "FlatTree.h"
+#include "GlyphMetrics.h"
+#include "ThreadPool.h"
+
+#include <cmath>
+#include <cstdio>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace cst;
+
+//
+// Parse, layout and render one tree, return the node x positions.
+//
+std::vector<double> work(const std::string &treeStr, const RenderOptions &options, const std::string &fileName)
+{
+    std::vector<double> xs;
+
+    auto syntaxTree = Parser::buildSyntaxTree(treeStr, options.maxTreeDepth);
+    if (!syntaxTree)
+    {
+        return xs;
+    }
+
+    TreeSize treeSize;
+    Layouter layouter(options);
+    if (!layouter.layout(syntaxTree->getRoot(), treeSize))
+    {
+        return xs;
+    }
+
+    Renderer renderer(syntaxTree, treeSize, fileName, options);
+    if (!renderer.drawTree())
+    {
+        return xs;
+    }
+    std::remove(fileName.c_str());
+
+    FlatTree flat(syntaxTree->getRoot());
+    for (auto node : flat.node)
+    {
+        xs.push_back(node->x());
+    }
+    return xs;
+}
+
+int test_concurrency()
+{
+    std::string treeStr = "[S [NP [Det the] [N tree]] [VP [V is] [AdjP [Adj laid] [PP out]] [Adv again]]]";
+
+    // Every job has its own settings.
+    const int jobCount = 8;
+    std::vector<RenderOptions> options(jobCount);
+    std::vector<std::vector<double>> expected(jobCount);
+    for (int i = 0; i < jobCount; ++i)
+    {
+        options[i].nodeHSep = 10.0 + i * 5.0;
+        options[i].nodeVSep = 20.0 + i;
+        options[i].fontSize = 8.0 + i;
+        options[i].fileType = (i % 2) ? "png" : "svg";
+        expected[i] = work(treeStr, options[i], "test10_expected_" + std::to_string(i));
+        if (expected[i].empty())
+        {
+            return 1;
+        }
+    }
+
+    std::vector<std::vector<double>> result(jobCount);
+    std::vector<std::thread> threads;
+    for (int i = 0; i < jobCount; ++i)
+    {
+        threads.emplace_back([&, i]()
+        {
+            for (int round = 0; round < 4; ++round)
+            {
+                result[i] = work(treeStr, options[i], "test10_job_" + std::to_string(i));
+            }
+        });
+    }
+    for (auto &thread : threads)
+    {
+        thread.join();
+    }
+
+    for (int i = 0; i < jobCount; ++i)
+    {
+        if (result[i] != expected[i])
+        {
+            std::cout << "job " << i << " result differs." << std::endl;
+            return 1;
+        }
+    }
+
+    std::cout << "--concurrent jobs are ok." << std::endl;
+    return 0;
+}
+
+//
+// A wide tree with many different labels, big enough to be measured in parallel.
+//
+void makeTree(SyntaxTree &tree, std::size_t nodeCount)
+{
+    auto root = tree.newNode("root");
+    Node *parent = root;
+    for (std::size_t i = 1; i < nodeCount; ++i)
+    {
+        auto node = tree.newNode("w" + std::to_string(i % 997));
+        parent->append(node);
+        if (i % 7 == 0)
+        {
+            parent = node;
+        }
+        else if (i % 11 == 0 && parent->parent())
+        {
+            parent = parent->parent();
+        }
+    }
+    tree.setRoot(root);
+}
+
+int test_parallel_measure()
+{
+    RenderOptions options;
+    SyntaxTree tree;
+    makeTree(tree, 50000);
+
+    Layouter serial(options);
+    TreeSize expectedSize;
+    if (!serial.layout(tree.getRoot(), expectedSize))
+    {
+        return 1;
+    }
+    FlatTree expected(tree.getRoot());
+    std::vector<double> expectedX;
+    for (auto node : expected.node)
+    {
+        expectedX.push_back(node->x());
+    }
+
+    // Measuring by per-worker cairo contexts or by shared glyph metrics
+    // gives the same layout as measuring on one thread.
+    for (int shared = 0; shared < 2; ++shared)
+    {
+        ThreadPool pool(4);
+        auto metrics = shared ? std::make_shared<GlyphMetrics>(options) : nullptr;
+        Layouter layouter(options, nullptr, metrics);
+        layouter.setThreadPool(&pool);
+
+        TreeSize treeSize;
+        if (!layouter.layout(tree.getRoot(), treeSize))
+        {
+            return 1;
+        }
+
+        FlatTree flat(tree.getRoot());
+        for (std::size_t i = 0; i < flat.size(); ++i)
+        {
+            if (std::abs(flat.width[i] - expected.width[i]) > 1e-9 
+                || std::abs(flat.node[i]->x() - expectedX[i]) > 1e-6)
+            {
+                std::cout << "parallel measure differs at node " << i << std::endl;
+                return 1;
+            }
+        }
+    }
+
+    std::cout << "--parallel measure is ok." << std::endl;
+    return 0;
+}
+
+int main()
+{
+    int i = 0;
+
+    i += test_concurrency();
+    i += test_parallel_measure();
+
+    return i;
+}
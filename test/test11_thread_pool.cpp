@@ -0,0 +1,84 @@
+/**
+ * The MIT License
+ *
+ * Copyright 2022 Krishna sssky307@163.com
+ *
+ * For the full copyright and license information, please view the LICENSE
+ * file that was distributed with this source code.
+ */
+
+#include "ThreadPool.h"
+
+#include <atomic>
+#include <iostream>
+#include <stdexcept>
+#include <vector>
+
+using namespace cst;
+
+int test_thread_pool()
+{
+    for (std::size_t size : {1, 2, 4, 8})
+    {
+        ThreadPool pool(size);
+        if (pool.size() != size)
+        {
+            return 1;
+        }
+
+        // The pool runs many rounds, every index exactly once per round.
+        for (std::size_t count : {0, 1, 7, 1000})
+        {
+            std::vector<std::atomic<int>> hits(count);
+            std::atomic<bool> badWorker{false};
+            pool.parallelFor(count, [&](std::size_t index, std::size_t worker)
+            {
+                ++hits[index];
+                if (worker >= pool.size())
+                {
+                    badWorker = true;
+                }
+            });
+
+            for (auto &hit : hits)
+            {
+                if (hit != 1)
+                {
+                    return 1;
+                }
+            }
+            if (badWorker)
+            {
+                return 1;
+            }
+        }
+
+        bool caught = false;
+        try
+        {
+            pool.parallelFor(100, [](std::size_t index, std::size_t)
+            {
+                if (index == 42)
+                {
+                    throw std::runtime_error("task failed");
+                }
+            });
+        }
+        catch (const std::runtime_error &)
+        {
+            caught = true;
+        }
+        if (!caught)
+        {
+            return 1;
+        }
+    }
+
+    std::cout << "--thread pool is ok." << std::endl;
+    return 0;
+}
+
+int main()
+{
+    return test_thread_pool();
+}
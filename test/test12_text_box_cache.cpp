@@ -0,0 +1,209 @@
+/**
+ * The MIT License
+ *
+ * Copyright 2022 Krishna sssky307@163.com
+ *
+ * For the full copyright and license information, please view the LICENSE
+ * file that was distributed with this source code.
+ */
+
+#include "TextBoxCache.h"
+#include "Boxy.h"
+#include "ThreadPool.h"
+
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace cst;
+
+TextBox makeTextBox(double width, double height, double xBearing, double yBearing)
+{
+    TextBox box;
+    box.width = width;
+    box.height = height;
+    box.xBearing = xBearing;
+    box.yBearing = yBearing;
+    return box;
+}
+
+bool sameTextBox(const TextBox &a, const TextBox &b)
+{
+    return a.width == b.width && a.height == b.height 
+        && a.xBearing == b.xBearing && a.yBearing == b.yBearing;
+}
+
+int test_cache()
+{
+    TextBoxCache cache;
+    auto box = makeTextBox(1.5, 2.25, -0.125, -7.0 / 3.0);
+    TextBox found;
+
+    if (cache.find("NP", 12.0, "serif", found) || cache.misses() != 1)
+    {
+        return 1;
+    }
+
+    cache.insert("NP", 12.0, "serif", box);
+    if (!cache.find("NP", 12.0, "serif", found) || !sameTextBox(found, box) || cache.hits() != 1)
+    {
+        return 1;
+    }
+
+    // The font size and the font face are a part of the key.
+    if (cache.find("NP", 13.0, "serif", found) || cache.find("NP", 12.0, "sans", found) 
+        || cache.size() != 1 || cache.hitRate() != 1.0 / 4.0)
+    {
+        return 1;
+    }
+
+    // The lookup key views a label which is not null terminated.
+    std::string text = "NPVP";
+    if (!cache.find(StrView(text.data(), 2), 12.0, "serif", found) || !sameTextBox(found, box))
+    {
+        return 1;
+    }
+
+    // Replacing a textbox keeps one entry.
+    auto other = makeTextBox(3.0, 4.0, 0.0, -1.0);
+    cache.insert("NP", 12.0, "serif", other);
+    if (cache.size() != 1 || !cache.find("NP", 12.0, "serif", found) || !sameTextBox(found, other))
+    {
+        return 1;
+    }
+
+    // A new key owns a copy of the label, a replaced one keeps its copy.
+    std::string label = "VP";
+    cache.insert(label, 12.0, "serif", box);
+    cache.insert(label, 12.0, "serif", other);
+    label = "XX";
+    if (cache.size() != 2 || !cache.find("VP", 12.0, "serif", found) || !sameTextBox(found, other))
+    {
+        return 1;
+    }
+
+    std::cout << "--textbox cache is ok." << std::endl;
+    return 0;
+}
+
+int test_save_load()
+{
+    TextBoxCache cache;
+    std::vector<std::string> labels{"NP", "a b", "line\nbreak", "R\"(label = \"x\")\"", "\xE4\xB8\xAD"};
+    for (std::size_t i = 0; i < labels.size(); ++i)
+    {
+        cache.insert(labels[i], 12.0, "sans serif", makeTextBox(0.1 * i, 1.0 / (i + 3), -0.3, -1e-17));
+    }
+    // An unknown font face is saved as an empty one.
+    cache.insert("NP", 12.0, "", makeTextBox(1.0, 2.0, 0.0, -2.0));
+
+    const char *fileName = "test_text_box_cache.txt";
+    if (!cache.save(fileName))
+    {
+        return 1;
+    }
+
+    // The values are read back exactly.
+    TextBoxCache loaded;
+    if (!loaded.load(fileName) || loaded.size() != labels.size() + 1)
+    {
+        return 1;
+    }
+    for (auto &label : labels)
+    {
+        TextBox a, b;
+        if (!cache.find(label, 12.0, "sans serif", a) || !loaded.find(label, 12.0, "sans serif", b) 
+            || !sameTextBox(a, b))
+        {
+            return 1;
+        }
+    }
+    TextBox a, b;
+    if (!cache.find("NP", 12.0, "", a) || !loaded.find("NP", 12.0, "", b) || !sameTextBox(a, b))
+    {
+        return 1;
+    }
+    std::remove(fileName);
+
+    if (loaded.load("no_such_cache_file.txt"))
+    {
+        return 1;
+    }
+
+    // A size over the limit is rejected before it is allocated.
+    for (auto entry : {"18446744073709551615 x", "0  12 1 2 0 -2 18446744073709551615 x"})
+    {
+        {
+            std::ofstream ofs(fileName, std::ios::binary);
+            ofs << "cpp-syntax-tree textbox cache 2\n" << entry << "\n";
+        }
+        TextBoxCache bad;
+        if (bad.load(fileName))
+        {
+            return 1;
+        }
+    }
+    std::remove(fileName);
+
+    std::cout << "--textbox cache save/load is ok." << std::endl;
+    return 0;
+}
+
+int test_shared_cache()
+{
+    RenderOptions options;
+    auto cache = std::make_shared<TextBoxCache>();
+    std::vector<std::string> labels{"S", "NP", "VP", "DT", "NN", "VBZ", "word"};
+
+    // Cached and measured textboxes are the same.
+    Boxy plain(options);
+    Boxy cached(options, cache);
+    for (int round = 0; round < 3; ++round)
+    {
+        for (auto &label : labels)
+        {
+            if (!sameTextBox(plain.getTextBox(label), cached.getTextBox(label)))
+            {
+                return 1;
+            }
+        }
+    }
+    if (cache->size() != labels.size() || cache->misses() != labels.size())
+    {
+        return 1;
+    }
+
+    // Many threads share one cache, each label is still measured once per
+    // thread at most.
+    ThreadPool pool(4);
+    std::vector<std::unique_ptr<Boxy>> boxies(pool.size());
+    cache->clear();
+    pool.parallelFor(1000, [&](std::size_t index, std::size_t worker)
+    {
+        if (!boxies[worker])
+        {
+            boxies[worker].reset(new Boxy(options, cache));
+        }
+        boxies[worker]->getTextBox(labels[index % labels.size()]);
+    });
+    if (cache->size() != labels.size() || cache->misses() > labels.size() * pool.size())
+    {
+        return 1;
+    }
+
+    std::cout << "--shared textbox cache is ok." << std::endl;
+    return 0;
+}
+
+int main()
+{
+    int i = 0;
+
+    i += test_cache();
+    i += test_save_load();
+    i += test_shared_cache();
+
+    return i;
+}
@@ -0,0 +1,149 @@
+/**
+ * The MIT License
+ *
+ * Copyright 2022 Krishna sssky307@163.com
+ *
+ * For the full copyright and license information, please view the LICENSE
+ * file that was distributed with this source code.
+ */
+
+#include "GlyphMetrics.h"
+#include "Boxy.h"
+#include "ThreadPool.h"
+
+#include <cmath>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace cst;
+
+static const std::vector<std::string> labels{
+    "S", "NP", "VP", "word", "Hello, World!", "a b  c", " ", "AVA To", 
+    "R\"(label)\"", "\xE4\xB8\xAD\xE6\x96\x87", "caf\xC3\xA9", "x = y + z;", 
+    "gjpqy", "\xF0\x9F\x8C\xB3"
+};
+
+bool nearTextBox(const TextBox &a, const TextBox &b, double tolerance)
+{
+    return std::fabs(a.width - b.width) <= tolerance 
+        && std::fabs(a.height - b.height) <= tolerance 
+        && std::fabs(a.xBearing - b.xBearing) <= tolerance 
+        && std::fabs(a.yBearing - b.yBearing) <= tolerance;
+}
+
+int test_agree_with_cairo()
+{
+    for (double fontSize : {8.0, 12.0, 31.5})
+    {
+        RenderOptions options;
+        options.fontSize = fontSize;
+
+        GlyphMetrics metrics(options);
+        Boxy boxy(options);
+        if (!metrics.good() || !boxy.good())
+        {
+            return 1;
+        }
+
+        for (auto &label : labels)
+        {
+            if (!nearTextBox(metrics.getTextBox(label), boxy.getTextBox(label), fontSize * 1e-6))
+            {
+                std::cout << "glyph metrics disagree on: " << label << std::endl;
+                return 1;
+            }
+        }
+    }
+
+    // Invalid utf-8 has no textbox: a cut sequence, overlong forms of "/"
+    // and U+0800, and the surrogates U+D800 and U+DFFF.
+    GlyphMetrics metrics;
+    for (auto label : {"a\xC3", "a\xC0\xAF", "a\xE0\x80\xAF", "a\xF0\x80\xA0\x80", 
+                       "a\xED\xA0\x80", "a\xED\xBF\xBF"})
+    {
+        auto textBox = metrics.getTextBox(label);
+        if (textBox.width != 0.0 || textBox.height != 0.0)
+        {
+            return 1;
+        }
+    }
+
+    // U+0800 in its shortest form, and U+D7FF and U+E000 around the
+    // surrogates are valid.
+    for (auto label : {"a\xE0\xA0\x80", "a\xED\x9F\xBF", "a\xEE\x80\x80"})
+    {
+        if (metrics.getTextBox(label).width == 0.0)
+        {
+            return 1;
+        }
+    }
+
+    std::cout << "--glyph metrics agree with cairo." << std::endl;
+    return 0;
+}
+
+int test_shared_metrics()
+{
+    RenderOptions options;
+    auto metrics = std::make_shared<GlyphMetrics>(options);
+    Boxy reference(options);
+
+    // A Boxy on shared metrics makes no cairo context of its own.
+    Boxy boxy(options, nullptr, metrics);
+    if (!boxy.good())
+    {
+        return 1;
+    }
+
+    std::vector<TextBox> expected;
+    for (auto &label : labels)
+    {
+        expected.push_back(reference.getTextBox(label));
+        if (!nearTextBox(boxy.getTextBox(label), expected.back(), options.fontSize * 1e-6))
+        {
+            return 1;
+        }
+    }
+
+    // Many threads fill the glyph and pair tables at the same time.
+    auto fresh = std::make_shared<GlyphMetrics>(options);
+    ThreadPool pool(4);
+    std::vector<int> bad(pool.size());
+    pool.parallelFor(2000, [&](std::size_t index, std::size_t worker)
+    {
+        auto i = index % labels.size();
+        if (!nearTextBox(fresh->getTextBox(labels[i]), expected[i], options.fontSize * 1e-6))
+        {
+            bad[worker] = 1;
+        }
+    });
+
+    // A different font size can not be used.
+    options.fontSize = 20.0;
+    if (Boxy(options, nullptr, metrics).good())
+    {
+        return 1;
+    }
+
+    for (auto b : bad)
+    {
+        if (b)
+        {
+            return 1;
+        }
+    }
+
+    std::cout << "--shared glyph metrics is ok." << std::endl;
+    return 0;
+}
+
+int main()
+{
+    int i = 0;
+
+    i += test_agree_with_cairo();
+    i += test_shared_metrics();
+
+    return i;
+}
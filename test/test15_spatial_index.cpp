@@ -0,0 +1,221 @@
+/**
+ * The MIT License
+ *
+ * Copyright 2022 Krishna sssky307@163.com
+ *
+ * For the full copyright and license information, please view the LICENSE
+ * file that was distributed with this source code.
+ */
+
+#include "SpatialIndex.h"
+#include "Layouter.h"
+#include "Parser.h"
+#include "SyntaxTree.h"
+
+#include <algorithm>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace cst;
+
+SpatialIndex::Rect makeRect(double x0, double y0, double x1, double y1)
+{
+    SpatialIndex::Rect rect;
+    rect.x0 = x0;
+    rect.y0 = y0;
+    rect.x1 = x1;
+    rect.y1 = y1;
+    return rect;
+}
+
+int test_query()
+{
+    // Random boxes of mixed sizes, the queries agree with a linear scan.
+    std::mt19937 random(21);
+    std::uniform_real_distribution<double> position(0.0, 10000.0);
+    std::uniform_real_distribution<double> size(0.0, 50.0);
+
+    std::vector<SpatialIndex::Item> items;
+    for (SpatialIndex::Id id = 0; id < 20000; ++id)
+    {
+        auto x = position(random);
+        auto y = position(random);
+        auto w = id % 100 == 0 ? size(random) * 100.0 : size(random);
+        items.push_back({makeRect(x, y, x + w, y + size(random)), id});
+    }
+
+    SpatialIndex index;
+    index.build(items);
+    if (index.size() != items.size())
+    {
+        return 1;
+    }
+
+    for (int i = 0; i < 200; ++i)
+    {
+        auto x = position(random);
+        auto y = position(random);
+        auto query = i % 2 == 0 ? makeRect(x, y, x, y) : makeRect(x, y, x + 500.0, y + 300.0);
+
+        std::vector<SpatialIndex::Id> expected;
+        for (auto& item : items)
+        {
+            if (item.rect.intersects(query))
+            {
+                expected.push_back(item.id);
+            }
+        }
+        if (index.query(query) != expected)
+        {
+            std::cout << "query " << i << " differs." << std::endl;
+            return 1;
+        }
+    }
+
+    auto bounds = index.bounds();
+    for (auto& item : items)
+    {
+        if (item.rect.x0 < bounds.x0 || item.rect.x1 > bounds.x1 
+            || item.rect.y0 < bounds.y0 || item.rect.y1 > bounds.y1)
+        {
+            return 1;
+        }
+    }
+
+    std::cout << "--spatial index query is ok." << std::endl;
+    return 0;
+}
+
+int test_empty()
+{
+    SpatialIndex index;
+    if (!index.query(makeRect(0, 0, 1, 1)).empty())
+    {
+        return 1;
+    }
+
+    index.build({{makeRect(1, 1, 2, 2), 7}});
+    if (index.query(makeRect(2, 2, 3, 3)) != std::vector<SpatialIndex::Id>{7}
+        || !index.query(makeRect(3, 3, 4, 4)).empty())
+    {
+        return 1;
+    }
+
+    index.clear();
+    if (index.size() != 0 || !index.query(makeRect(1, 1, 2, 2)).empty())
+    {
+        return 1;
+    }
+
+    std::cout << "--empty spatial index is ok." << std::endl;
+    return 0;
+}
+
+int test_syntax_tree()
+{
+    std::string buf = "[S";
+    for (int i = 0; i < 300; ++i)
+    {
+        buf += " [NP [D the] [N word" + std::to_string(i) + "]] [VP [V runs]]";
+    }
+    buf += "]";
+
+    auto tree = Parser::buildSyntaxTree(buf);
+    RenderOptions options;
+    Layouter layouter(options);
+    TreeSize treeSize;
+    if (!tree || !layouter.layout(tree->getRoot(), treeSize))
+    {
+        return 1;
+    }
+
+    if (tree->nodeAt(0, 0) != nullptr || !tree->nodesIn(-1e9, -1e9, 1e9, 1e9).empty())
+    {
+        return 1;
+    }
+    tree->buildSpatialIndex();
+
+    NodeArray nodes;
+    NodeArray stack{tree->getRoot()};
+    while (!stack.empty())
+    {
+        auto node = stack.back();
+        stack.pop_back();
+        nodes.push_back(node);
+        for (auto &child : node->childArray())
+        {
+            stack.push_back(child);
+        }
+    }
+
+    // Every node is found at its own position.
+    for (auto node : nodes)
+    {
+        if (tree->nodeAt(node->x(), node->y()) != node)
+        {
+            std::cout << "node " << node->id() << " is not hit." << std::endl;
+            return 1;
+        }
+    }
+    if (tree->nodeAt(treeSize.xmin - 100.0, 0.0) != nullptr)
+    {
+        return 1;
+    }
+
+    // Viewports agree with a walk over all nodes.
+    std::mt19937 random(22);
+    std::uniform_real_distribution<double> x(treeSize.xmin, treeSize.xmax);
+    std::uniform_real_distribution<double> y(0.0, treeSize.ymax);
+    for (int i = 0; i < 100; ++i)
+    {
+        auto x0 = x(random);
+        auto y0 = y(random);
+        auto x1 = x0 + 800.0;
+        auto y1 = y0 + 60.0;
+
+        std::vector<std::size_t> expected;
+        for (auto node : nodes)
+        {
+            auto &box = node->textBox();
+            if (node->x() - box.width * 0.5 <= x1 && x0 <= node->x() + box.width * 0.5 
+                && node->y() - box.height * 0.5 <= y1 && y0 <= node->y() + box.height * 0.5)
+            {
+                expected.push_back(node->id());
+            }
+        }
+        std::sort(expected.begin(), expected.end());
+
+        std::vector<std::size_t> found;
+        for (auto node : tree->nodesIn(x0, y0, x1, y1))
+        {
+            found.push_back(node->id());
+        }
+        if (found != expected)
+        {
+            std::cout << "viewport " << i << " differs." << std::endl;
+            return 1;
+        }
+    }
+
+    tree->setRoot(nullptr);
+    if (!tree->nodesIn(-1e9, -1e9, 1e9, 1e9).empty())
+    {
+        return 1;
+    }
+
+    std::cout << "--syntax tree hit testing is ok." << std::endl;
+    return 0;
+}
+
+int main()
+{
+    int i = 0;
+
+    i += test_query();
+    i += test_empty();
+    i += test_syntax_tree();
+
+    return i;
+}
@@ -0,0 +1,141 @@
+/**
+ * The MIT License
+ *
+ * Copyright 2022 Krishna sssky307@163.com
+ *
+ * For the full copyright and license information, please view the LICENSE
+ * file that was distributed with this source code.
+ */
+
+#include "GlyphRunCache.h"
+#include "Renderer.h"
+#include "Parser.h"
+#include "Layouter.h"
+
+#include <cstdio>
+#include <iostream>
+#include <string>
+
+using namespace cst;
+
+int test_convert_once()
+{
+    CairoContext ctx;
+    if (!ctx.good())
+    {
+        return 1;
+    }
+    auto font = cairo_get_scaled_font(ctx.cr());
+    auto face = ctx.fontFace();
+    RenderOptions options;
+    auto size = options.fontSize;
+
+    GlyphRunCache cache;
+    std::string label = "word";
+    auto &run = cache.glyphs(font, face, size, label);
+    if (run.size() != label.size() || cache.size() != 1)
+    {
+        return 1;
+    }
+
+    // The pen starts at the origin and moves right.
+    if (run.front().x != 0.0 || run.front().y != 0.0 || run.back().x <= 0.0)
+    {
+        return 1;
+    }
+
+    // The same label from another buffer is found, not converted again.
+    std::string other = "a word";
+    auto &found = cache.glyphs(font, face, size, StrView(other.data() + 2, 4));
+    if (&found != &run || cache.size() != 1)
+    {
+        return 1;
+    }
+
+    cache.glyphs(font, face, size, "words");
+    if (cache.size() != 2)
+    {
+        return 1;
+    }
+
+    // The font face and size are a part of the key.
+    if (&cache.glyphs(font, face, size * 2, label) == &run 
+        || &cache.glyphs(font, "other face", size, label) == &run
+        || cache.size() != 4)
+    {
+        return 1;
+    }
+
+    std::cout << "glyph run convert once pass." << std::endl;
+    return 0;
+}
+
+int test_empty_run()
+{
+    CairoContext ctx;
+    if (!ctx.good())
+    {
+        return 1;
+    }
+    auto font = cairo_get_scaled_font(ctx.cr());
+    auto face = ctx.fontFace();
+    RenderOptions options;
+
+    // An empty label and invalid utf-8 have no glyphs, they are cached too.
+    GlyphRunCache cache;
+    if (!cache.glyphs(font, face, options.fontSize, "").empty() 
+        || !cache.glyphs(font, face, options.fontSize, "\xC3").empty() 
+        || !cache.glyphs(font, face, options.fontSize, "a\x80z").empty()
+        || cache.size() != 3)
+    {
+        return 1;
+    }
+
+    std::cout << "glyph run empty pass." << std::endl;
+    return 0;
+}
+
+int test_shared_by_renderers()
+{
+    RenderOptions options;
+    options.fileType = "png";
+    Layouter layouter(options);
+    auto cache = std::make_shared<GlyphRunCache>();
+
+    // The renderers of one job convert each label once.
+    for (auto str : {"[S [NP a] [VP a]]", "[S [VP a] [NP b]]"})
+    {
+        auto tree = Parser::buildSyntaxTree(str);
+        TreeSize treeSize;
+        if (!tree || !layouter.layout(tree->getRoot(), treeSize))
+        {
+            return 1;
+        }
+        Renderer renderer(tree, treeSize, "test_glyph_run_cache.png", options);
+        renderer.setGlyphRunCache(cache);
+        if (!renderer.drawTree())
+        {
+            return 1;
+        }
+    }
+    std::remove("test_glyph_run_cache.png");
+
+    if (cache->size() != 5)
+    {
+        return 1;
+    }
+
+    std::cout << "glyph run shared by renderers pass." << std::endl;
+    return 0;
+}
+
+int main()
+{
+    int i = 0;
+
+    i += test_convert_once();
+    i += test_empty_run();
+    i += test_shared_by_renderers();
+
+    return i;
+}